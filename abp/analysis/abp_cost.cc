@@ -0,0 +1,144 @@
+#include "fastmpc/abp/analysis/abp_cost.h"
+
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+namespace fastmpc::abp {
+
+namespace {
+
+constexpr size_t kElementBytes = 8;
+
+// Rounds and elements sent per output element, following flux/low/aby3.
+struct OpCost {
+  size_t rounds = 0;
+  size_t elements = 0;
+};
+
+// reshare of the cross terms
+constexpr OpCost kMultiplyCost{1, 3};
+// truncation pair: P1 -> P0 and P0 -> P2
+constexpr OpCost kTruncateCost{1, 2};
+// a truncation folded into the product it follows, see
+// ABY3Lower::collect_fused_products: the reshare is replaced by 4 messages
+constexpr OpCost kFusedTruncateCost{0, 1};
+// boolean reshare, one AND and ceil(log2(width)) Kogge-Stone levels of two
+// ANDs, 6 for the full ring
+constexpr auto a2b_cost(uint8_t width) -> OpCost {
+  size_t levels = std::bit_width(static_cast<unsigned>(width - 1));
+  return OpCost{2 + levels, 6 + 6 * levels};
+}
+// Kogge-Stone with a precomputed mask, plus opening x1 to P0 and P1
+constexpr OpCost kB2ACost{8, 44};
+
+class CostModel {
+public:
+  explicit CostModel(const ABPContext &context)
+      : context_(&context), uses_(context.ops_size(), 0) {
+    for (size_t i = 0; i < context.ops_size(); i++) {
+      for (auto operand : context.operands(OpHandle(i))) {
+        uses_[operand.unwarp()]++;
+      }
+    }
+  }
+
+  auto op_cost(OpHandle handle) const -> OpCost {
+    return context_->visit(handle, [&](OpHandle, auto &&op) -> OpCost {
+      using T = std::decay_t<decltype(op)>;
+      if constexpr (std::is_same_v<T, MultiplyAAOp> ||
+                    std::is_same_v<T, AndBBOp> ||
+                    std::is_same_v<T, DotGeneralAAOp> ||
+                    std::is_same_v<T, DotProductAAOp>) {
+        return kMultiplyCost;
+      } else if constexpr (std::is_same_v<T, TruncateAOp>) {
+        return is_fused_product(op.operand) ? kFusedTruncateCost
+                                            : kTruncateCost;
+      } else if constexpr (std::is_same_v<T, A2BOp>) {
+        return a2b_cost(op.width);
+      } else if constexpr (std::is_same_v<T, B2AOp>) {
+        return kB2ACost;
+      } else {
+        return OpCost{};
+      }
+    });
+  }
+
+  auto elements(OpHandle handle) const -> size_t {
+    auto &shape = context_->shape(handle);
+    return std::accumulate(shape.begin(), shape.end(), size_t{1},
+                           std::multiplies<>());
+  }
+
+private:
+  auto is_fused_product(OpHandle handle) const -> bool {
+    if (uses_[handle.unwarp()] != 1) {
+      return false;
+    }
+    return context_->visit(handle, [](OpHandle, auto &&op) {
+      using T = std::decay_t<decltype(op)>;
+      return std::is_same_v<T, MultiplyAAOp> ||
+             std::is_same_v<T, DotGeneralAAOp> ||
+             std::is_same_v<T, DotProductAAOp>;
+    });
+  }
+
+  const ABPContext *context_;
+  std::vector<size_t> uses_;
+};
+
+auto estimate_cost(const ABPContext &context,
+                   const std::vector<bool> &selected) -> Cost {
+  CostModel model(context);
+  std::vector<size_t> depth(context.ops_size(), 0);
+  Cost cost;
+  for (size_t i = 0; i < context.ops_size(); i++) {
+    if (!selected[i]) {
+      continue;
+    }
+    OpHandle handle(i);
+    for (auto operand : context.operands(handle)) {
+      depth[i] = std::max(depth[i], depth[operand.unwarp()]);
+    }
+    auto op_cost = model.op_cost(handle);
+    if (op_cost.rounds == 0 && op_cost.elements == 0) {
+      continue;
+    }
+    depth[i] += op_cost.rounds;
+    cost.rounds = std::max(cost.rounds, depth[i]);
+    cost.bytes += op_cost.elements * model.elements(handle) * kElementBytes;
+  }
+  return cost;
+}
+
+} // namespace
+
+auto estimate_cost(const ABPContext &context) -> Cost {
+  std::vector<bool> selected(context.ops_size(), true);
+  return estimate_cost(context, selected);
+}
+
+auto estimate_cost(const ABPContext &context, OpHandle root) -> Cost {
+  // ops are created after their operands, so one backward sweep is enough
+  std::vector<bool> selected(context.ops_size(), false);
+  selected[root.unwarp()] = true;
+  for (size_t i = root.unwarp() + 1; i-- > 0;) {
+    if (!selected[i]) {
+      continue;
+    }
+    for (auto operand : context.operands(OpHandle(i))) {
+      selected[operand.unwarp()] = true;
+    }
+  }
+  return estimate_cost(context, selected);
+}
+
+auto estimate_time(const Cost &cost, const NetworkModel &network) -> double {
+  return static_cast<double>(cost.rounds) * network.latency +
+         static_cast<double>(cost.bytes) / network.bandwidth;
+}
+
+} // namespace fastmpc::abp
\ No newline at end of file
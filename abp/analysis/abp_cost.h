@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+
+#include "fastmpc/abp/dialect/abp_context.h"
+#include "fastmpc/abp/dialect/abp_ops.h"
+
+namespace fastmpc::abp {
+
+// Communication of a program under the ABY3 lowering: rounds on the critical
+// path and bytes sent by all parties together.
+struct Cost {
+  size_t rounds = 0;
+  size_t bytes = 0;
+};
+
+// Link between the parties: seconds per round of messages and bytes per
+// second. The defaults describe a LAN.
+struct NetworkModel {
+  double latency = 2e-4;
+  double bandwidth = 1.25e9;
+};
+
+// Cost of every op in the context.
+auto estimate_cost(const ABPContext &context) -> Cost;
+
+// Cost of the ops `root` depends on.
+auto estimate_cost(const ABPContext &context, OpHandle root) -> Cost;
+
+// Seconds to run a program of `cost` on `network`.
+auto estimate_time(const Cost &cost, const NetworkModel &network) -> double;
+
+} // namespace fastmpc::abp
\ No newline at end of file
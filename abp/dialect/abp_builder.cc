@@ -1,12 +1,15 @@
 #include "fastmpc/abp/dialect/abp_builder.h"
 #include "fastmpc/abp/dialect/abp_context.h"
 #include "fastmpc/abp/dialect/abp_ops.h"
+#include "fastmpc/abp/dialect/abp_range.h"
 #include "fastmpc/abp/dialect/abp_types.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <functional>
 #include <numeric>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -69,6 +72,7 @@ DECL_PUSH(BroadcastOp, broadcast_ops_)
 DECL_PUSH(ReshapeOp, reshape_ops_)
 DECL_PUSH(SliceOp, slice_ops_)
 DECL_PUSH(TransposeOp, transpose_ops_)
+DECL_PUSH(ReduceSumOp, reduce_sum_ops_)
 DECL_PUSH(AddAAOp, add_aa_ops_)
 DECL_PUSH(AddAPOp, add_ap_ops_)
 DECL_PUSH(AddPPOp, add_pp_ops_)
@@ -78,6 +82,9 @@ DECL_PUSH(MultiplyPPOp, multiply_pp_ops_)
 DECL_PUSH(XorBBOp, xor_bb_ops_)
 DECL_PUSH(AndBBOp, and_bb_ops_)
 DECL_PUSH(DotGeneralAAOp, dot_general_ops_)
+DECL_PUSH(DotGeneralAPOp, dot_general_ap_ops_)
+DECL_PUSH(DotProductAAOp, dot_product_ops_)
+DECL_PUSH(GatherOp, gather_ops_)
 DECL_PUSH(ConcateOp, concat_ops_)
 DECL_PUSH(TruncateAOp, truncate_a_ops_)
 DECL_PUSH(TruncatePOp, truncate_p_ops_)
@@ -146,21 +153,101 @@ DECL_BIT_OP(AndBBOp, and_bb, bb)
 DECL_BIT_OP(XorBBOp, xor_bb, bb)
 #undef DECL_BIT_OP
 
-auto ABPBuilder::dot_general_aa(OpHandle left, OpHandle right) -> OpHandle {
+auto ABPBuilder::dot_general_result(OpHandle left, OpHandle right,
+                                    bool transpose_left, bool transpose_right)
+    -> Type {
+  auto left_type = inner_->type(left);
+  auto right_type = inner_->type(right);
+  Shape left_shape = inner_->shape(left);
+  Shape right_shape = inner_->shape(right);
+  // [batch..., m, k] x [batch..., k, n] = [batch..., m, n]
+  size_t rank = left_shape.size();
+  assert(rank >= 2 && right_shape.size() == rank);
+  assert(std::equal(left_shape.begin(), left_shape.end() - 2,
+                    right_shape.begin()));
+  if (transpose_left) {
+    std::swap(left_shape[rank - 2], left_shape[rank - 1]);
+  }
+  if (transpose_right) {
+    std::swap(right_shape[rank - 2], right_shape[rank - 1]);
+  }
+  assert(left_shape[rank - 1] == right_shape[rank - 2]);
+  uint8_t fixed_point = left_type.fixed_point + right_type.fixed_point;
+  left_shape[rank - 1] = right_shape[rank - 1];
+  // secret when either operand is
+  auto kind = is_p(left) ? right_type.kind : left_type.kind;
+  return Type{
+      .kind = kind,
+      .fixed_point = fixed_point,
+      .shape = push(std::move(left_shape)),
+  };
+}
+
+// A transpose that only swaps the last two dimensions becomes a flag of the
+// product, its operand is read in place.
+void ABPBuilder::fold_transpose(OpHandle &operand, bool &transposed) const {
+  inner_->visit(operand, [&](OpHandle, auto &&op) {
+    using T = std::decay_t<decltype(op)>;
+    if constexpr (std::is_same_v<T, TransposeOp>) {
+      auto &permutation = inner_->dense_size_t(op.permutation);
+      size_t rank = permutation.size();
+      for (size_t i = 0; i + 2 < rank; i++) {
+        if (permutation[i] != i) {
+          return;
+        }
+      }
+      if (rank >= 2 && permutation[rank - 2] == rank - 1 &&
+          permutation[rank - 1] == rank - 2) {
+        operand = op.operand;
+        transposed = !transposed;
+      }
+    }
+  });
+}
+
+auto ABPBuilder::dot_general_aa(OpHandle left, OpHandle right,
+                                bool transpose_left, bool transpose_right)
+    -> OpHandle {
   assert(is_aa(left, right));
+  fold_transpose(left, transpose_left);
+  fold_transpose(right, transpose_right);
+  return push_op(DotGeneralAAOp{
+      .type = dot_general_result(left, right, transpose_left, transpose_right),
+      .left = left,
+      .right = right,
+      .transpose_left = transpose_left,
+      .transpose_right = transpose_right,
+  });
+}
+
+auto ABPBuilder::dot_general_ap(OpHandle left, OpHandle right,
+                                bool transpose_left, bool transpose_right)
+    -> OpHandle {
+  assert(is_ap(left, right) || is_ap(right, left));
+  fold_transpose(left, transpose_left);
+  fold_transpose(right, transpose_right);
+  return push_op(DotGeneralAPOp{
+      .type = dot_general_result(left, right, transpose_left, transpose_right),
+      .left = left,
+      .right = right,
+      .transpose_left = transpose_left,
+      .transpose_right = transpose_right,
+  });
+}
+
+auto ABPBuilder::dot_product_aa(OpHandle left, OpHandle right) -> OpHandle {
+  assert(is_aa(left, right) && check_shape(left, right));
   auto left_type = inner_->type(left);
   auto right_type = inner_->type(right);
-  auto &left_shape = inner_->shape(left);
-  auto &right_shape = inner_->shape(right);
-  assert(left_shape.size() == 2 && right_shape.size() == 2);
-  assert(left_shape[1] == right_shape[0]);
+  auto &shape = inner_->shape(left);
+  assert(!shape.empty());
   uint8_t fixed_point = left_type.fixed_point + right_type.fixed_point;
   auto type = Type{
       .kind = left_type.kind,
       .fixed_point = fixed_point,
-      .shape = push(Shape{left_shape[0], right_shape[1]}),
+      .shape = push(Shape(shape.begin(), shape.end() - 1)),
   };
-  return push_op(DotGeneralAAOp{
+  return push_op(DotProductAAOp{
       .type = type,
       .left = left,
       .right = right,
@@ -227,13 +314,19 @@ auto ABPBuilder::p2a(OpHandle operand) -> OpHandle {
 }
 
 auto ABPBuilder::a2b(OpHandle operand) -> OpHandle {
-  assert(is_a(operand));
+  auto fixed_point = inner_->type(operand).fixed_point;
+  return a2b(operand, signed_width(inner_->range(operand), fixed_point));
+}
+
+auto ABPBuilder::a2b(OpHandle operand, uint8_t width) -> OpHandle {
+  assert(is_a(operand) && width > 0 && width <= 64);
   auto type = inner_->type(operand);
   type.kind = TypeKind::kBitArray64;
   type.fixed_point = 0;
   return push_op(A2BOp{
       .type = type,
       .operand = operand,
+      .width = width,
   });
 }
 
@@ -354,6 +447,27 @@ auto ABPBuilder::transpose(OpHandle operand,
   });
 }
 
+auto ABPBuilder::reduce_sum(OpHandle operand,
+                            DenseSizeT dimensions) -> OpHandle {
+  assert(!is_b(operand));
+  auto type = inner_->type(operand);
+  auto &in_shape = inner_->shape(operand);
+  Shape out_shape;
+  for (size_t i = 0; i < in_shape.size(); i++) {
+    if (std::find(dimensions.begin(), dimensions.end(), i) ==
+        dimensions.end()) {
+      out_shape.push_back(in_shape[i]);
+    }
+  }
+  assert(out_shape.size() + dimensions.size() == in_shape.size());
+  type.shape = push(std::move(out_shape));
+  return push_op(ReduceSumOp{
+      .type = type,
+      .operand = operand,
+      .dimensions = push(std::move(dimensions)),
+  });
+}
+
 namespace {
 
 auto slice_shape(const DenseSizeT &start, const DenseSizeT &end,
@@ -387,6 +501,73 @@ auto ABPBuilder::slice(OpHandle operand, DenseSizeT start, DenseSizeT end,
   });
 }
 
+auto ABPBuilder::gather(OpHandle operand, OpHandle indices, size_t size)
+    -> OpHandle {
+  assert(is_p(indices));
+  auto type = inner_->type(operand);
+  auto &in_shape = inner_->shape(operand);
+  assert(!in_shape.empty() && size <= in_shape[0]);
+  // [indices..., size, operand[1:]...]
+  Shape shape = inner_->shape(indices);
+  shape.push_back(size);
+  shape.insert(shape.end(), in_shape.begin() + 1, in_shape.end());
+  type.shape = push(std::move(shape));
+  return push_op(GatherOp{
+      .type = type,
+      .left = operand,
+      .right = indices,
+      .size = size,
+  });
+}
+
+auto ABPBuilder::clone(const ABPContext &source, OpHandle handle,
+                       std::vector<OpHandle> operands) -> OpHandle {
+  assert(&source != inner_);
+  assert(source.operands(handle).size() == operands.size());
+  auto copy = [&](DenseSizeTHandle attribute) {
+    return push(DenseSizeT(source.dense_size_t(attribute)));
+  };
+  return source.visit(handle, [&](OpHandle, auto op) {
+    if constexpr (requires { op.type; }) {
+      op.type.shape = push(Shape(source.shape(op.type.shape)));
+    }
+    if constexpr (requires { op.operands; }) {
+      op.operands = std::move(operands);
+    } else if constexpr (requires { op.left; }) {
+      op.left = operands[0];
+      op.right = operands[1];
+    } else if constexpr (requires { op.operand; }) {
+      op.operand = operands[0];
+    }
+    if constexpr (requires { op.value; }) {
+      op.value = push(DenseValue(source.dense_value(op.value)));
+    }
+    if constexpr (requires { op.dimensions; }) {
+      op.dimensions = copy(op.dimensions);
+    }
+    if constexpr (requires { op.permutation; }) {
+      op.permutation = copy(op.permutation);
+    }
+    if constexpr (requires { op.stride; }) {
+      op.start = copy(op.start);
+      op.end = copy(op.end);
+      op.stride = copy(op.stride);
+    }
+    return push_op(std::move(op));
+  });
+}
+
+void ABPBuilder::assume(OpHandle operand, Range range) {
+  auto full = full_range(inner_->type(operand));
+  auto [assumption, _] =
+      inner_->assumptions_.try_emplace(operand.unwarp(), full);
+  assumption->second = assumption->second.intersect(range);
+  if (operand.unwarp() < inner_->ranges_.size()) {
+    auto &known = inner_->ranges_[operand.unwarp()];
+    known = known.intersect(range);
+  }
+}
+
 auto ABPBuilder::is_a(OpHandle operand) const -> bool {
   return inner_->type(operand).kind == TypeKind::kArithFixed64;
 }
@@ -25,7 +25,14 @@ class ABPBuilder {
         auto multiply_aa(OpHandle left, OpHandle right)    -> OpHandle;
         auto multiply_ap(OpHandle left, OpHandle right)    -> OpHandle;
         auto multiply_pp(OpHandle left, OpHandle right)    -> OpHandle;
-        auto dot_general_aa(OpHandle left, OpHandle right) -> OpHandle;
+        // matrix products of the last two dimensions, the leading ones are
+        // batch dimensions shared by both operands. A flagged operand is read
+        // with its last two dimensions swapped, an operand built by a
+        // transpose of just those two dimensions is folded into its flag.
+        // dot_general_ap takes the public operand on either side.
+        auto dot_general_aa(OpHandle left, OpHandle right, bool transpose_left = false, bool transpose_right = false) -> OpHandle;
+        auto dot_general_ap(OpHandle left, OpHandle right, bool transpose_left = false, bool transpose_right = false) -> OpHandle;
+        auto dot_product_aa(OpHandle left, OpHandle right) -> OpHandle;
 
         auto softmax(OpHandle operand, int64_t axis) -> OpHandle;
         auto gelu(OpHandle operand) -> OpHandle;
@@ -41,7 +48,9 @@ class ABPBuilder {
         auto shift_right(OpHandle operand, uint8_t bits) -> OpHandle;
 
         auto p2a(OpHandle operand) -> OpHandle;
+        // a2b over the fewest bits that hold the range of `operand`
         auto a2b(OpHandle operand) -> OpHandle;
+        auto a2b(OpHandle operand, uint8_t width) -> OpHandle;
         auto b2a(OpHandle operand, uint8_t fixed_point) -> OpHandle;
 
         auto constant(DenseValueHandle value, Type type) -> OpHandle;
@@ -49,13 +58,27 @@ class ABPBuilder {
         auto concate(std::vector<OpHandle> &&operands, size_t dimension) -> OpHandle;
         auto reshape(OpHandle operand, ShapeHandle shape) -> OpHandle;
         auto transpose(OpHandle operand, DenseSizeT permutation) -> OpHandle;
+        auto reduce_sum(OpHandle operand, DenseSizeT dimensions) -> OpHandle;
         auto slice(OpHandle operand, DenseSizeT tart, DenseSizeT end) -> OpHandle;
         auto slice(OpHandle operand, DenseSizeT tart, DenseSizeT end, DenseSizeT stride) -> OpHandle;
+        // `size` rows of `operand` from every public index, a local copy of
+        // the rows on every share
+        auto gather(OpHandle operand, OpHandle indices, size_t size = 1) -> OpHandle;
+
+        // `handle` of `source` with its operands replaced by `operands`, the
+        // attributes are copied into this context
+        auto clone(const ABPContext &source, OpHandle handle, std::vector<OpHandle> operands) -> OpHandle;
+
+        // narrows the range of `operand` to values known from the semantics
+        // of the function that built it
+        void assume(OpHandle operand, Range range);
 
         template <class T> auto push(T &&value) -> typename T::handle_type;
         private:
             template <class T> auto push_op(T &&op) -> OpHandle;
             auto multiply_result(OpHandle left, OpHandle right) -> Type;
+            auto dot_general_result(OpHandle left, OpHandle right, bool transpose_left, bool transpose_right) -> Type;
+            void fold_transpose(OpHandle &operand, bool &transposed) const;
             auto is_a(OpHandle operand) const -> bool;
             auto is_b(OpHandle operand) const -> bool;
             auto is_p(OpHandle operand) const -> bool;
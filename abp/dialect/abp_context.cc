@@ -23,6 +23,20 @@ auto ABPContext::type(OpHandle handle) const -> Type {
   return visit(handle, [](OpHandle, auto &&op) { return type_of(op); });
 }
 
+auto ABPContext::operands(OpHandle handle) const -> std::vector<OpHandle> {
+  return visit(handle, [](OpHandle, auto &&op) -> std::vector<OpHandle> {
+    if constexpr (requires { op.operands; }) {
+      return op.operands;
+    } else if constexpr (requires { op.left; }) {
+      return {op.left, op.right};
+    } else if constexpr (requires { op.operand; }) {
+      return {op.operand};
+    } else {
+      return {};
+    }
+  });
+}
+
 void ABPContext::print(std::ostream &out, OpHandle handle) const {
   return visit(handle, [&](OpHandle, auto &&op) { op.print(out, *this); });
 }
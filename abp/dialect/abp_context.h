@@ -1,9 +1,11 @@
 #pragma once
 
 #include "fastmpc/abp/dialect/abp_ops.h"
+#include "fastmpc/abp/dialect/abp_range.h"
 #include "fastmpc/abp/dialect/abp_types.h"
 
 #include <iosfwd>
+#include <unordered_map>
 #include <vector>
 
 #include "fastmpc/ir_base/unique_vector.h"
@@ -41,6 +43,13 @@ public:
 
   auto ops_size() const -> size_t { return ops_.size(); }
 
+  // Operands of `op` in declaration order.
+  auto operands(OpHandle op) const -> std::vector<OpHandle>;
+
+  // Bounds on the values of `op`, propagated from its operands and narrowed
+  // by ABPBuilder::assume.
+  auto range(OpHandle op) const -> Range;
+
   template <class Func> auto visit(OpHandle handle, Func &&func) const {
     auto op = ops_[handle.unwarp()];
     switch (op.kind) {
@@ -80,6 +89,8 @@ public:
       return func(handle, slice_ops_[op.offset]);
     case OpKind::kTransposeOp:
       return func(handle, transpose_ops_[op.offset]);
+    case OpKind::kReduceSumOp:
+      return func(handle, reduce_sum_ops_[op.offset]);
     case OpKind::kAddAAOp:
       return func(handle, add_aa_ops_[op.offset]);
     case OpKind::kAddAPOp:
@@ -98,6 +109,12 @@ public:
       return func(handle, and_bb_ops_[op.offset]);
     case OpKind::kDotGeneralAAOp:
       return func(handle, dot_general_ops_[op.offset]);
+    case OpKind::kDotGeneralAPOp:
+      return func(handle, dot_general_ap_ops_[op.offset]);
+    case OpKind::kDotProductAAOp:
+      return func(handle, dot_product_ops_[op.offset]);
+    case OpKind::kGatherOp:
+      return func(handle, gather_ops_[op.offset]);
     case OpKind::kConcateOp:
       return func(handle, concat_ops_[op.offset]);
     }
@@ -106,6 +123,8 @@ public:
 private:
   friend class ABPBuilder;
 
+  auto infer_range(OpHandle op) const -> Range;
+
   // types
   UniqueVector<Shape> shape_list_;
 
@@ -130,6 +149,7 @@ private:
   UniqueVector<ReshapeOp> reshape_ops_;
   UniqueVector<SliceOp> slice_ops_;
   UniqueVector<TransposeOp> transpose_ops_;
+  UniqueVector<ReduceSumOp> reduce_sum_ops_;
   UniqueVector<TruncateAOp> truncate_a_ops_;
   UniqueVector<TruncatePOp> truncate_p_ops_;
 
@@ -143,10 +163,17 @@ private:
   UniqueVector<XorBBOp> xor_bb_ops_;
   UniqueVector<AndBBOp> and_bb_ops_;
   UniqueVector<DotGeneralAAOp> dot_general_ops_;
+  UniqueVector<DotGeneralAPOp> dot_general_ap_ops_;
+  UniqueVector<DotProductAAOp> dot_product_ops_;
+  UniqueVector<GatherOp> gather_ops_;
 
   UniqueVector<ConcateOp> concat_ops_;
 
   UniqueVector<Op> ops_;
+
+  // ranges are inferred lazily, in op order
+  std::unordered_map<size_t, Range> assumptions_;
+  mutable std::vector<Range> ranges_;
 };
 
 } // namespace fastmpc::abp
\ No newline at end of file
@@ -95,7 +95,6 @@ DEF_UNARY_OP(InverseOp, inverse)
 DEF_UNARY_OP(NotBOp, not_b)
 DEF_UNARY_OP(BitReverseOp, bit_reverse)
 DEF_UNARY_OP(P2AOp, p2a)
-DEF_UNARY_OP(A2BOp, a2b)
 DEF_UNARY_OP(B2AOp, b2a)
 DEF_UNARY_OP(ReshapeOp, reshape)
 #undef DEF_UNARY_OP
@@ -133,10 +132,12 @@ auto unwarped(DenseSizeTHandle handle, const ABPContext &context) {
            Attr == other.Attr;                                                 \
   }
 DEF_UNARY_OP(ShiftRightOp, shift_right, bits)
+DEF_UNARY_OP(A2BOp, a2b, width)
 DEF_UNARY_OP(TruncateAOp, truncate_a, bits)
 DEF_UNARY_OP(TruncatePOp, truncate_p, bits)
 DEF_UNARY_OP(BroadcastOp, broadcast, dimensions)
 DEF_UNARY_OP(TransposeOp, transpose, permutation)
+DEF_UNARY_OP(ReduceSumOp, reduce_sum, dimensions)
 #undef DEF_UNARY_OP
 
 auto SliceOp::hash() const -> size_t {
@@ -200,9 +201,73 @@ DEF_BINARY_OP(MultiplyAPOp, multiply_ap)
 DEF_BINARY_OP(MultiplyPPOp, multiply_pp)
 DEF_BINARY_OP(XorBBOp, xor_bb)
 DEF_BINARY_OP(AndBBOp, and_bb)
-DEF_BINARY_OP(DotGeneralAAOp, dot_general)
+DEF_BINARY_OP(DotProductAAOp, dot_product)
 #undef DEF_BINARY_OP
 
+#define DEF_DOT_GENERAL_OP(OpName, Name)                                       \
+  auto OpName::hash() const->size_t {                                          \
+    FVNContext context;                                                        \
+    context.push(type.hash());                                                 \
+    context.push(left);                                                        \
+    context.push(right);                                                       \
+    context.push(static_cast<size_t>(transpose_left));                         \
+    context.push(static_cast<size_t>(transpose_right));                        \
+    return context.value();                                                    \
+  }                                                                            \
+  void OpName::print(std::ostream &out, const ABPContext &context) const {     \
+    out << #Name << ' ';                                                       \
+    left.print(out);                                                           \
+    out << ", ";                                                               \
+    right.print(out);                                                          \
+    out << ", ";                                                               \
+    print_attr(out, "transpose_left", static_cast<size_t>(transpose_left));    \
+    out << ", ";                                                               \
+    print_attr(out, "transpose_right", static_cast<size_t>(transpose_right));  \
+    out << ": (";                                                              \
+    context.type(left).print(out, context);                                    \
+    out << ", ";                                                               \
+    context.type(right).print(out, context);                                   \
+    out << ") -> ";                                                            \
+    type.print(out, context);                                                  \
+  }                                                                            \
+  auto OpName::operator==(const OpName &other) const->bool {                   \
+    return type == other.type && left == other.left && right == other.right && \
+           transpose_left == other.transpose_left &&                           \
+           transpose_right == other.transpose_right;                           \
+  }
+DEF_DOT_GENERAL_OP(DotGeneralAAOp, dot_general)
+DEF_DOT_GENERAL_OP(DotGeneralAPOp, dot_general_ap)
+#undef DEF_DOT_GENERAL_OP
+
+auto GatherOp::hash() const -> size_t {
+  FVNContext context;
+  context.push(type.hash());
+  context.push(left);
+  context.push(right);
+  context.push(size);
+  return context.value();
+}
+
+void GatherOp::print(std::ostream &out, const ABPContext &context) const {
+  out << "gather ";
+  left.print(out);
+  out << ", ";
+  right.print(out);
+  out << ", ";
+  print_attr(out, "size", size);
+  out << ": (";
+  context.type(left).print(out, context);
+  out << ", ";
+  context.type(right).print(out, context);
+  out << ") -> ";
+  type.print(out, context);
+}
+
+auto GatherOp::operator==(const GatherOp &other) const -> bool {
+  return type == other.type && left == other.left && right == other.right &&
+         size == other.size;
+}
+
 auto ConcateOp::hash() const -> size_t {
   FVNContext context;
   context.push(type.hash());
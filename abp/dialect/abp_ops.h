@@ -31,6 +31,7 @@ enum class OpKind {
   kReshapeOp,
   kSliceOp,
   kTransposeOp,
+  kReduceSumOp,
 
   // binary ops
   kAddAAOp,
@@ -42,6 +43,9 @@ enum class OpKind {
   kXorBBOp,
   kAndBBOp,
   kDotGeneralAAOp,
+  kDotGeneralAPOp,
+  kDotProductAAOp,
+  kGatherOp,
 
   kConcateOp,
 };
@@ -122,13 +126,17 @@ DECL_UNARY_OP(ShiftRightOp, uint8_t bits;);
 DECL_UNARY_OP(TruncateAOp, uint8_t bits;);
 DECL_UNARY_OP(TruncatePOp, uint8_t bits;);
 DECL_UNARY_OP(P2AOp);
-DECL_UNARY_OP(A2BOp);
+// Only the low `width` bits are added up, the result is exact when the
+// operand fits in `width` bits of two's complement.
+DECL_UNARY_OP(A2BOp, uint8_t width;);
 DECL_UNARY_OP(B2AOp);
 DECL_UNARY_OP(BroadcastOp, DenseSizeTHandle dimensions;);
 DECL_UNARY_OP(ReshapeOp);
 DECL_UNARY_OP(SliceOp, DenseSizeTHandle start; DenseSizeTHandle end;
               DenseSizeTHandle stride;);
 DECL_UNARY_OP(TransposeOp, DenseSizeTHandle permutation;);
+// Sums out `dimensions`, which are dropped from the result shape.
+DECL_UNARY_OP(ReduceSumOp, DenseSizeTHandle dimensions;);
 #undef DECL_UNARY_OP
 
 #define DECL_BINARY_OP(OpName, ...)                                            \
@@ -151,7 +159,18 @@ DECL_BINARY_OP(MultiplyAPOp);
 DECL_BINARY_OP(MultiplyPPOp);
 DECL_BINARY_OP(XorBBOp);
 DECL_BINARY_OP(AndBBOp);
-DECL_BINARY_OP(DotGeneralAAOp);
+// Matrix products of the last two dimensions, an operand with its flag set is
+// read with those two dimensions swapped.
+DECL_BINARY_OP(DotGeneralAAOp, bool transpose_left; bool transpose_right;);
+// The public operand of DotGeneralAPOp may be on either side.
+DECL_BINARY_OP(DotGeneralAPOp, bool transpose_left; bool transpose_right;);
+// Contracts the last dimension of two operands of the same shape.
+DECL_BINARY_OP(DotProductAAOp);
+// Slices of `size` rows of the left operand along its first dimension, one
+// starting at every index of the public right operand. A start is clamped so
+// that its slice stays in bounds. The result is
+// [right shape..., size, left shape[1:]...].
+DECL_BINARY_OP(GatherOp, size_t size;);
 #undef DECL_BINARY_OP
 
 struct ConcateOp {
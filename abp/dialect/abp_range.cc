@@ -0,0 +1,199 @@
+#include "fastmpc/abp/dialect/abp_range.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+
+#include "fastmpc/abp/dialect/abp_context.h"
+#include "fastmpc/abp/dialect/abp_ops.h"
+
+namespace fastmpc::abp {
+
+auto Range::non_negative() -> Range {
+  return Range{0, std::numeric_limits<double>::infinity()};
+}
+
+auto Range::magnitude() const -> double {
+  return std::max(std::abs(lower), std::abs(upper));
+}
+
+auto Range::intersect(const Range &other) const -> Range {
+  return Range{std::max(lower, other.lower), std::min(upper, other.upper)};
+}
+
+auto Range::hull(const Range &other) const -> Range {
+  return Range{std::min(lower, other.lower), std::max(upper, other.upper)};
+}
+
+auto full_range(const Type &type) -> Range {
+  if (type.kind == TypeKind::kBitArray64) {
+    return Range{0, std::ldexp(1.0, 64)};
+  }
+  auto bound = std::ldexp(1.0, 63 - type.fixed_point);
+  return Range{-bound, bound};
+}
+
+auto signed_width(const Range &range, uint8_t fixed_point) -> uint8_t {
+  auto raw = std::ceil(std::ldexp(range.magnitude(), fixed_point));
+  if (!(raw < std::ldexp(1.0, 62))) {
+    return 64;
+  }
+  // one more bit for the sign
+  return std::bit_width(static_cast<uint64_t>(raw)) + 1;
+}
+
+namespace {
+
+auto product(const Range &left, const Range &right) -> Range {
+  double candidates[] = {left.lower * right.lower, left.lower * right.upper,
+                         left.upper * right.lower, left.upper * right.upper};
+  return Range{*std::min_element(std::begin(candidates), std::end(candidates)),
+               *std::max_element(std::begin(candidates), std::end(candidates))};
+}
+
+auto scale(const Range &range, double factor) -> Range {
+  return Range{range.lower * factor, range.upper * factor};
+}
+
+auto elements(const Shape &shape) -> size_t {
+  return std::accumulate(shape.begin(), shape.end(), size_t{1},
+                         std::multiplies<>());
+}
+
+} // namespace
+
+auto ABPContext::range(OpHandle handle) const -> Range {
+  // operands are created before their users
+  for (size_t i = ranges_.size(); i <= handle.unwarp(); i++) {
+    ranges_.push_back(infer_range(OpHandle(i)));
+  }
+  return ranges_[handle.unwarp()];
+}
+
+auto ABPContext::infer_range(OpHandle handle) const -> Range {
+  auto inferred = visit(handle, [&](OpHandle, auto &&op) -> Range {
+    using T = std::decay_t<decltype(op)>;
+    if constexpr (std::is_same_v<T, OutputOp>) {
+      return range(op.operand);
+    } else {
+      auto full = full_range(op.type);
+      // one unit in the last place of the result
+      auto ulp = std::ldexp(1.0, -op.type.fixed_point);
+      Range result = full;
+      if constexpr (std::is_same_v<T, ConstantOp>) {
+        auto &value = dense_value(op.value);
+        if (!value.empty()) {
+          result = Range{std::numeric_limits<double>::infinity(),
+                         -std::numeric_limits<double>::infinity()};
+        }
+        for (auto element : value) {
+          double decoded =
+              op.type.kind == TypeKind::kBitArray64
+                  ? static_cast<double>(element)
+                  : std::ldexp(static_cast<double>(
+                                   static_cast<int64_t>(element)),
+                               -op.type.fixed_point);
+          result = result.hull(Range{decoded, decoded});
+        }
+      } else if constexpr (std::is_same_v<T, NegateAOp> ||
+                           std::is_same_v<T, NegatePOp>) {
+        auto operand = range(op.operand);
+        result = Range{-operand.upper, -operand.lower};
+      } else if constexpr (std::is_same_v<T, TruncateAOp> ||
+                           std::is_same_v<T, TruncatePOp>) {
+        auto exponent = type(op.operand).fixed_point - op.bits -
+                        op.type.fixed_point;
+        result = scale(range(op.operand), std::ldexp(1.0, exponent));
+        // both round down, truncate_a by up to kTruncationError more units
+        result.lower -= ulp;
+        if constexpr (std::is_same_v<T, TruncateAOp>) {
+          result.lower -= kTruncationError * ulp;
+        }
+      } else if constexpr (std::is_same_v<T, ShiftRightOp>) {
+        result = Range{
+            0, std::floor(std::ldexp(range(op.operand).upper, -op.bits))};
+      } else if constexpr (std::is_same_v<T, P2AOp> ||
+                           std::is_same_v<T, BroadcastOp> ||
+                           std::is_same_v<T, ReshapeOp> ||
+                           std::is_same_v<T, SliceOp> ||
+                           std::is_same_v<T, TransposeOp>) {
+        result = range(op.operand);
+      } else if constexpr (std::is_same_v<T, GatherOp>) {
+        // rows of the table, wherever the indices point
+        result = range(op.left);
+      } else if constexpr (std::is_same_v<T, A2BOp>) {
+        auto operand = range(op.operand);
+        if (operand.is_non_negative()) {
+          result = Range{0, std::ldexp(operand.upper,
+                                       type(op.operand).fixed_point)};
+        }
+      } else if constexpr (std::is_same_v<T, B2AOp>) {
+        auto operand = range(op.operand);
+        if (operand.upper < std::ldexp(1.0, 63)) {
+          result = Range{0, std::ldexp(operand.upper, -op.type.fixed_point)};
+        }
+      } else if constexpr (std::is_same_v<T, ReduceSumOp>) {
+        auto count = elements(shape(op.operand)) / elements(shape(handle));
+        result = scale(range(op.operand), static_cast<double>(count));
+      } else if constexpr (std::is_same_v<T, AddAAOp> ||
+                           std::is_same_v<T, AddAPOp> ||
+                           std::is_same_v<T, AddPPOp>) {
+        auto left = range(op.left);
+        auto right = range(op.right);
+        result = Range{left.lower + right.lower, left.upper + right.upper};
+      } else if constexpr (std::is_same_v<T, MultiplyAAOp> ||
+                           std::is_same_v<T, MultiplyAPOp> ||
+                           std::is_same_v<T, MultiplyPPOp>) {
+        result = product(range(op.left), range(op.right));
+        if (op.left == op.right) {
+          // a square is never negative
+          result.lower = std::max(result.lower, 0.0);
+        }
+      } else if constexpr (std::is_same_v<T, DotGeneralAAOp> ||
+                           std::is_same_v<T, DotGeneralAPOp> ||
+                           std::is_same_v<T, DotProductAAOp>) {
+        // the contracted dimension is the last one of the left operand, the
+        // one before it when the left operand is read transposed
+        auto &left_shape = shape(op.left);
+        auto count = left_shape.back();
+        if constexpr (requires { op.transpose_left; }) {
+          if (op.transpose_left) {
+            count = left_shape[left_shape.size() - 2];
+          }
+        }
+        result = scale(product(range(op.left), range(op.right)),
+                       static_cast<double>(count));
+      } else if constexpr (std::is_same_v<T, AndBBOp>) {
+        result = Range{0, std::min(range(op.left).upper,
+                                   range(op.right).upper)};
+      } else if constexpr (std::is_same_v<T, XorBBOp>) {
+        auto upper = std::max(range(op.left).upper, range(op.right).upper);
+        if (upper < std::ldexp(1.0, 63)) {
+          auto bits = std::bit_width(static_cast<uint64_t>(upper));
+          result = Range{0, std::ldexp(1.0, bits) - 1};
+        }
+      } else if constexpr (std::is_same_v<T, ConcateOp>) {
+        result = range(op.operands[0]);
+        for (auto operand : op.operands) {
+          result = result.hull(range(operand));
+        }
+      }
+      // values outside of the type wrap around
+      if (result.lower < full.lower || result.upper > full.upper) {
+        result = full;
+      }
+      return result;
+    }
+  });
+  auto assumption = assumptions_.find(handle.unwarp());
+  if (assumption != assumptions_.end()) {
+    inferred = inferred.intersect(assumption->second);
+  }
+  return inferred;
+}
+
+} // namespace fastmpc::abp
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+
+#include "fastmpc/abp/dialect/abp_types.h"
+
+namespace fastmpc::abp {
+
+// Every component of the truncation mask is drawn from [0, 2^61), see
+// flux::aby3::truncation_pair, a truncated value has to stay below it.
+constexpr uint8_t kMaskHeadroom = 3;
+// truncate_a of the ABY3 lowering drops the carries of adding up the three
+// shifted mask components and floors the opened value, each one unit.
+constexpr int kTruncationError = 3;
+
+// Bounds on the values of an op, raw / 2^fixed_point for a and p values and
+// the unsigned bit pattern for b values. Truncations of a values may land up to
+// kTruncationError units in the last place below the floor of the quotient,
+// which the bounds include.
+struct Range {
+  double lower;
+  double upper;
+
+  // [0, inf), to be intersected with the range of a type
+  static auto non_negative() -> Range;
+
+  auto is_non_negative() const -> bool { return lower >= 0; }
+  auto is_negative() const -> bool { return upper < 0; }
+  // largest absolute value
+  auto magnitude() const -> double;
+
+  auto intersect(const Range &other) const -> Range;
+  auto hull(const Range &other) const -> Range;
+};
+
+// Every value of `type`.
+auto full_range(const Type &type) -> Range;
+
+// Fewest bits of two's complement that hold the raw values of an a or p value
+// in `range`, at most 64.
+auto signed_width(const Range &range, uint8_t fixed_point) -> uint8_t;
+
+} // namespace fastmpc::abp
\ No newline at end of file
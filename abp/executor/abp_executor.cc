@@ -2,12 +2,14 @@
 
 #include <algorithm>
 #include <bitset>
+#include <cstddef>
 #include <cstdint>
 #include <ostream>
 #include <vector>
 
 #include "fastmpc/abp/dialect/abp_ops.h"
 #include "fastmpc/abp/dialect/abp_types.h"
+#include "fastmpc/abp/executor/abp_kernels.h"
 #include "fastmpc/eager/tensor.h"
 #include "fastmpc/eager/tensor_ops.h"
 
@@ -85,7 +87,19 @@ void ABPExecutor::operator()(OpHandle handle, P2AOp op) {
 
 void ABPExecutor::operator()(OpHandle handle, A2BOp op) {
   auto operand = map_.find(op.operand)->second;
-  map_.emplace(handle, operand);
+  if (op.width == 64) {
+    map_.emplace(handle, operand);
+    return;
+  }
+  // sign extension of the low `width` bits, as the ABY3 lowering computes
+  auto result = eager::Tensor::with_shape(operand.shape());
+  uint8_t bits = 64 - op.width;
+  std::transform(operand.data(), operand.data() + operand.num_elements(),
+                 result.data(), [bits](uint64_t value) {
+                   return static_cast<uint64_t>(
+                       static_cast<int64_t>(value << bits) >> bits);
+                 });
+  map_.emplace(handle, result);
 }
 
 void ABPExecutor::operator()(OpHandle handle, B2AOp op) {
@@ -124,6 +138,13 @@ void ABPExecutor::operator()(OpHandle handle, TransposeOp op) {
   map_.emplace(handle, operand.transpose(permutation));
 }
 
+void ABPExecutor::operator()(OpHandle handle, ReduceSumOp op) {
+  auto operand = map_.find(op.operand)->second;
+  auto &dimensions = context_->dense_size_t(op.dimensions);
+  auto &shape = context_->shape(op.type.shape);
+  map_.emplace(handle, reduce_sum(operand, dimensions, shape));
+}
+
 void ABPExecutor::operator()(OpHandle handle, AddAAOp op) {
   auto x = map_.find(op.left)->second;
   auto y = map_.find(op.right)->second;
@@ -175,7 +196,34 @@ void ABPExecutor::operator()(OpHandle handle, AndBBOp op) {
 void ABPExecutor::operator()(OpHandle handle, DotGeneralAAOp op) {
   auto x = map_.find(op.left)->second;
   auto y = map_.find(op.right)->second;
-  map_.emplace(handle, eager::matmul(x, y));
+  map_.emplace(handle,
+               batch_matmul(x, y, op.transpose_left, op.transpose_right));
+}
+
+void ABPExecutor::operator()(OpHandle handle, DotGeneralAPOp op) {
+  auto x = map_.find(op.left)->second;
+  auto y = map_.find(op.right)->second;
+  map_.emplace(handle,
+               batch_matmul(x, y, op.transpose_left, op.transpose_right));
+}
+
+void ABPExecutor::operator()(OpHandle handle, DotProductAAOp op) {
+  auto x = map_.find(op.left)->second;
+  auto y = map_.find(op.right)->second;
+  auto &shape = context_->shape(op.left);
+  DenseSizeT dimensions(1);
+  dimensions[0] = shape.size() - 1;
+  auto product = eager::multiply(x, y);
+  auto &result_shape = context_->shape(op.type.shape);
+  map_.emplace(handle, reduce_sum(product, dimensions, result_shape));
+}
+
+void ABPExecutor::operator()(OpHandle handle, GatherOp op) {
+  auto table = map_.find(op.left)->second;
+  auto indices = map_.find(op.right)->second;
+  auto fixed_point = context_->type(op.right).fixed_point;
+  auto &shape = context_->shape(op.type.shape);
+  map_.emplace(handle, gather(table, indices, fixed_point, op.size, shape));
 }
 
 void ABPExecutor::operator()(OpHandle handle, ConcateOp op) {
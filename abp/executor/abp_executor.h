@@ -38,6 +38,7 @@ public:
   void operator()(OpHandle handle, ReshapeOp op);
   void operator()(OpHandle handle, SliceOp op);
   void operator()(OpHandle handle, TransposeOp op);
+  void operator()(OpHandle handle, ReduceSumOp op);
   void operator()(OpHandle handle, AddAAOp op);
   void operator()(OpHandle handle, AddAPOp op);
   void operator()(OpHandle handle, AddPPOp op);
@@ -47,6 +48,9 @@ public:
   void operator()(OpHandle handle, XorBBOp op);
   void operator()(OpHandle handle, AndBBOp op);
   void operator()(OpHandle handle, DotGeneralAAOp op);
+  void operator()(OpHandle handle, DotGeneralAPOp op);
+  void operator()(OpHandle handle, DotProductAAOp op);
+  void operator()(OpHandle handle, GatherOp op);
   void operator()(OpHandle handle, ConcateOp op);
   void print_value(std::ostream &out, OpHandle handle) override;
 
@@ -0,0 +1,107 @@
+#include "fastmpc/abp/executor/abp_kernels.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "fastmpc/eager/tensor_ops.h"
+
+#include "absl/container/inlined_vector.h"
+
+namespace fastmpc::abp {
+
+auto reduce_sum(const eager::Tensor &operand, const DenseSizeT &dimensions,
+                const Shape &shape) -> eager::Tensor {
+  auto in_shape = operand.shape();
+  auto result = eager::Tensor::with_shape(shape);
+  std::fill_n(result.data(), result.num_elements(), 0);
+
+  // output stride of every input dimension, reduced dimensions do not move
+  absl::InlinedVector<size_t, 8> strides(in_shape.size(), 0);
+  size_t stride = 1;
+  for (size_t i = in_shape.size(); i-- > 0;) {
+    if (std::find(dimensions.begin(), dimensions.end(), i) ==
+        dimensions.end()) {
+      strides[i] = stride;
+      stride *= in_shape[i];
+    }
+  }
+
+  absl::InlinedVector<size_t, 8> index(in_shape.size(), 0);
+  auto *in = operand.data();
+  auto *out = result.data();
+  size_t offset = 0;
+  for (size_t n = 0; n < operand.num_elements(); n++) {
+    out[offset] += in[n];
+    for (size_t i = in_shape.size(); i-- > 0;) {
+      offset += strides[i];
+      if (++index[i] < in_shape[i]) {
+        break;
+      }
+      offset -= strides[i] * in_shape[i];
+      index[i] = 0;
+    }
+  }
+  return result;
+}
+
+auto batch_matmul(const eager::Tensor &x, const eager::Tensor &y,
+                  bool transpose_x, bool transpose_y) -> eager::Tensor {
+  auto x_shape = x.shape();
+  auto y_shape = y.shape();
+  size_t rank = x_shape.size();
+  if (rank == 2 && !transpose_x && !transpose_y) {
+    return eager::matmul(x, y);
+  }
+  size_t rows = x_shape[transpose_x ? rank - 1 : rank - 2];
+  size_t inner = x_shape[transpose_x ? rank - 2 : rank - 1];
+  size_t columns = y_shape[transpose_y ? rank - 2 : rank - 1];
+  Shape shape(x_shape.begin(), x_shape.end());
+  shape[rank - 2] = rows;
+  shape[rank - 1] = columns;
+  auto result = eager::Tensor::with_shape(shape);
+  std::fill_n(result.data(), result.num_elements(), 0);
+
+  // distances between consecutive elements along each matrix dimension
+  size_t x_row = transpose_x ? 1 : inner;
+  size_t x_inner = transpose_x ? rows : 1;
+  size_t y_inner = transpose_y ? 1 : columns;
+  size_t y_column = transpose_y ? inner : 1;
+  size_t batches = rows == 0 ? 0 : result.num_elements() / (rows * columns);
+  for (size_t b = 0; b < batches; b++) {
+    auto *left = x.data() + b * rows * inner;
+    auto *right = y.data() + b * inner * columns;
+    auto *out = result.data() + b * rows * columns;
+    for (size_t i = 0; i < rows; i++) {
+      auto *out_row = out + i * columns;
+      for (size_t k = 0; k < inner; k++) {
+        auto scale = left[i * x_row + k * x_inner];
+        auto *right_row = right + k * y_inner;
+        for (size_t j = 0; j < columns; j++) {
+          out_row[j] += scale * right_row[j * y_column];
+        }
+      }
+    }
+  }
+  return result;
+}
+
+auto gather(const eager::Tensor &table, const eager::Tensor &indices,
+            uint8_t fixed_point, size_t size, const Shape &shape)
+    -> eager::Tensor {
+  size_t rows = table.shape()[0];
+  size_t row_size = rows == 0 ? 0 : table.num_elements() / rows;
+  auto last = static_cast<int64_t>(rows - size);
+  auto result = eager::Tensor::with_shape(shape);
+  auto *in = table.data();
+  auto *out = result.data();
+  for (size_t i = 0; i < indices.num_elements(); i++) {
+    auto index = static_cast<int64_t>(indices.data()[i]) >> fixed_point;
+    auto start = static_cast<size_t>(std::clamp<int64_t>(index, 0, last));
+    std::copy_n(in + start * row_size, size * row_size,
+                out + i * size * row_size);
+  }
+  return result;
+}
+
+} // namespace fastmpc::abp
\ No newline at end of file
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "fastmpc/eager/tensor.h"
+#include "fastmpc/ir_base/attribute.h"
+
+namespace fastmpc::abp {
+
+// Tensor kernels of the plaintext executors, ABPExecutor and FluxExecutor run
+// their local ops through the same code.
+
+// Accumulates every element of `operand` into the output element that drops
+// its `dimensions` coordinates, in a single pass over the input.
+auto reduce_sum(const eager::Tensor &operand, const DenseSizeT &dimensions,
+                const Shape &shape) -> eager::Tensor;
+
+// Matrix products of the last two dimensions for every index of the leading
+// batch dimensions. A transposed operand is read in place through its
+// strides, each element of x scales a row of y.
+auto batch_matmul(const eager::Tensor &x, const eager::Tensor &y,
+                  bool transpose_x, bool transpose_y) -> eager::Tensor;
+
+// `size` rows of `table` from every index, one contiguous copy per index.
+// The indices are at `fixed_point`, a start is clamped so that its rows stay
+// in bounds.
+auto gather(const eager::Tensor &table, const eager::Tensor &indices,
+            uint8_t fixed_point, size_t size, const Shape &shape)
+    -> eager::Tensor;
+
+} // namespace fastmpc::abp
\ No newline at end of file
@@ -1,6 +1,9 @@
 #include "fastmpc/abp/function/abp_binary.h"
+#include "fastmpc/abp/function/abp_reduce.h"
 #include "fastmpc/abp/function/abp_unary.h"
+#include <cassert>
 #include <cstdlib>
+#include <utility>
 
 using namespace std;
 
@@ -28,7 +31,7 @@ namespace fastmpc::abp {
     }
 
     namespace unsafe {
-        auto multiply(ABPBuilder &builder, OpHandle left, OpHandle right) {
+        auto multiply(ABPBuilder &builder, OpHandle left, OpHandle right) -> OpHandle {
             auto &context   = builder.context();
             auto left_kind  = context.type(left).kind;
             auto right_kind = context.type(right).kind;
@@ -46,14 +49,18 @@ namespace fastmpc::abp {
             }
         }
 
-        auto dot_general(ABPBuilder &builder, OpHandle left, OpHandle right) {
+        auto dot_general(ABPBuilder &builder, OpHandle left, OpHandle right,
+                         bool transpose_left, bool transpose_right) {
             auto &context   = builder.context();
             auto left_kind  = context.type(left).kind;
             auto right_kind = context.type(right).kind;
 
             switch (encode(left_kind, right_kind)) {
                 case encode(TypeKind::kArithFixed64, TypeKind::kArithFixed64):
-                    return builder.dot_general_aa(left, right);
+                    return builder.dot_general_aa(left, right, transpose_left, transpose_right);
+                case encode(TypeKind::kArithFixed64, TypeKind::kFixed64):
+                case encode(TypeKind::kFixed64, TypeKind::kArithFixed64):
+                    return builder.dot_general_ap(left, right, transpose_left, transpose_right);
                 default: abort();
             }
         }
@@ -72,9 +79,23 @@ namespace fastmpc::abp {
         return result;
     }
 
-    auto dot_general(ABPBuilder &builder, OpHandle left, OpHandle right) -> OpHandle {
+    auto multiply_all(ABPBuilder &builder, vector<OpHandle> operands) -> OpHandle {
+        assert(!operands.empty());
+        while (operands.size() > 1) {
+            vector<OpHandle> next;
+            for (size_t i = 0; i + 1 < operands.size(); i += 2)
+                next.push_back(multiply(builder, operands[i], operands[i + 1]));
+            if (operands.size() % 2 == 1)
+                next.push_back(operands.back());
+            operands = move(next);
+        }
+        return operands[0];
+    }
+
+    auto dot_general(ABPBuilder &builder, OpHandle left, OpHandle right,
+                     bool transpose_left, bool transpose_right) -> OpHandle {
         auto &context = builder.context();
-        auto result = unsafe::dot_general(builder, left, right);
+        auto result = unsafe::dot_general(builder, left, right, transpose_left, transpose_right);
 
         uint8_t fixed_point = context.type(result).fixed_point;
         if (fixed_point > builder.fixed_point()) {
@@ -85,6 +106,40 @@ namespace fastmpc::abp {
         return result;
     }
 
+    auto dot_product(ABPBuilder &builder, OpHandle left, OpHandle right, size_t axis) -> OpHandle {
+        auto &context = builder.context();
+        auto shape = context.shape(left);
+        assert(axis < shape.size());
+
+        // move `axis` to the last dimension
+        if (axis + 1 != shape.size()) {
+            DenseSizeT permutation(shape.size());
+            for (size_t i = 0; i < shape.size(); i++) {
+                if (i < axis) permutation[i] = i;
+                else if (i == axis) permutation[i] = shape.size() - 1;
+                else permutation[i] = i - 1;
+            }
+            left  = builder.transpose(left, DenseSizeT(permutation));
+            right = builder.transpose(right, ~permutation);
+        }
+
+        OpHandle result(0);
+        if (context.type(left).kind == TypeKind::kArithFixed64 &&
+            context.type(right).kind == TypeKind::kArithFixed64) {
+            result = builder.dot_product_aa(left, right);
+        } else {
+            auto product = unsafe::multiply(builder, left, right);
+            result = reduce_sum(builder, product, {shape.size() - 1});
+        }
+
+        uint8_t fixed_point = context.type(result).fixed_point;
+        if (fixed_point > builder.fixed_point()) {
+            uint8_t bits = fixed_point - builder.fixed_point();
+            result = truncate(builder, result, bits);
+        }
+        return result;
+    }
+
     auto bitwise_xor(ABPBuilder &builder, OpHandle left, OpHandle right) -> OpHandle {
         auto &context   = builder.context();
         auto left_kind  = context.type(left).kind;
@@ -1,12 +1,24 @@
 #pragma once
 #include "fastmpc/abp/dialect/abp_builder.h"
+#include <vector>
 
 namespace fastmpc::abp {
 
     auto add(ABPBuilder &builder, OpHandle left, OpHandle right) -> OpHandle;
     auto subtract(ABPBuilder &builder, OpHandle left, OpHandle right) -> OpHandle;
     auto multiply(ABPBuilder &builder, OpHandle left, OpHandle right) -> OpHandle;
-    auto dot_general(ABPBuilder &builder, OpHandle left, OpHandle right) -> OpHandle;
+    namespace unsafe {
+        // product without truncation, the fixed points of the operands add up
+        auto multiply(ABPBuilder &builder, OpHandle left, OpHandle right) -> OpHandle;
+    }
+    // product of all operands as a balanced tree, log2(n) multiplications deep
+    auto multiply_all(ABPBuilder &builder, std::vector<OpHandle> operands) -> OpHandle;
+    // matrix product of the last two dimensions, a flagged operand is read with
+    // them swapped instead of being transposed
+    auto dot_general(ABPBuilder &builder, OpHandle left, OpHandle right,
+                     bool transpose_left = false, bool transpose_right = false) -> OpHandle;
+    // reduce_sum(multiply(left, right), {axis}) with a single truncation
+    auto dot_product(ABPBuilder &builder, OpHandle left, OpHandle right, size_t axis) -> OpHandle;
     
     auto bitwise_xor(ABPBuilder &builder, OpHandle left, OpHandle right) -> OpHandle;
     auto bitwise_or(ABPBuilder &builder, OpHandle left, OpHandle right) -> OpHandle;
@@ -1,6 +1,7 @@
 #include "fastmpc/abp/function/abp_circuit.h"
 
 #include "fastmpc/abp/function/abp_binary.h"
+#include "fastmpc/abp/function/abp_constant.h"
 
 namespace fastmpc::abp {
 
@@ -32,4 +33,47 @@ auto bit_reverse(ABPBuilder &builder, OpHandle x, uint8_t perfix) -> OpHandle {
   return builder.b2a(x, builder.fixed_point());
 }
 
+auto thermometer_count_bits(ABPBuilder &builder, OpHandle mask)
+    -> std::vector<OpHandle> {
+  // For a mask with c low ones, bit k of c is the parity of the mask bits at
+  // 2^k - 1, 2 * 2^k - 1, ..., collected into bit 0 by xor folding.
+  std::vector<OpHandle> bits;
+  for (size_t k = 0; k < 7; k++) {
+    size_t step = size_t{1} << k;
+    auto folded = step == 1 ? mask : builder.shift_right(mask, step - 1);
+    for (size_t stride = step; stride < 64; stride *= 2) {
+      folded = builder.xor_bb(folded, builder.shift_right(folded, stride));
+    }
+    // keep bit 0 only
+    bits.push_back(builder.shift_right(builder.bit_reverse(folded), 63));
+  }
+  return bits;
+}
+
+auto thermometer_count(ABPBuilder &builder, OpHandle mask) -> OpHandle {
+  auto bits = thermometer_count_bits(builder, mask);
+  // move bit k back into place
+  auto count = bits[0];
+  for (size_t k = 1; k < bits.size(); k++) {
+    auto bit = builder.shift_right(builder.bit_reverse(bits[k]), 63 - k);
+    count = builder.xor_bb(count, bit);
+  }
+  return builder.b2a(count, 0);
+}
+
+auto normalize(ABPBuilder &builder, OpHandle x) -> Normalized {
+  uint8_t fixed_point = builder.fixed_point();
+  auto mask = perfix_or(builder, builder.a2b(x));
+  auto highest = builder.xor_bb(mask, builder.shift_right(mask, 1));
+  auto factor = bit_reverse(builder, highest, 2 * fixed_point);
+
+  auto count = thermometer_count(builder, mask);
+  auto offset = constant_like(builder, x, -static_cast<uint64_t>(fixed_point));
+  return Normalized{
+      .factor = factor,
+      .exponent = add(builder, count, offset),
+      .mask = mask,
+  };
+}
+
 } // namespace fastmpc::abp
\ No newline at end of file
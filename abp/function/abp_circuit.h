@@ -2,6 +2,8 @@
 
 #include "fastmpc/abp/dialect/abp_builder.h"
 
+#include <vector>
+
 namespace fastmpc::abp {
 
 auto msb(ABPBuilder &builder, OpHandle x) -> OpHandle;
@@ -12,4 +14,28 @@ auto highest_one_bit(ABPBuilder &builder, OpHandle x) -> OpHandle;
 
 auto bit_reverse(ABPBuilder &builder, OpHandle x, uint8_t perfix) -> OpHandle;
 
+// Bits 0 to 6 of the number of ones of a prefix-or mask such as the output
+// of perfix_or. Bit k is returned in bit 0 of the k-th boolean value, using
+// local ops only.
+auto thermometer_count_bits(ABPBuilder &builder, OpHandle mask)
+    -> std::vector<OpHandle>;
+
+// Number of ones of a prefix-or mask, as an arithmetic integer. Uses local
+// boolean ops and a single b2a.
+auto thermometer_count(ABPBuilder &builder, OpHandle mask) -> OpHandle;
+
+struct Normalized {
+  // x * factor lies in [0.5, 1)
+  OpHandle factor;
+  // x = (x * factor) * 2^exponent, an integer with fixed point 0
+  OpHandle exponent;
+  // prefix-or of x as a boolean value, exponent + fixed_point ones
+  OpHandle mask;
+};
+
+// Normalizes a positive x from a single bit decomposition. Ops are
+// deduplicated by the context, so callers normalizing the same tensor share
+// all of the work.
+auto normalize(ABPBuilder &builder, OpHandle x) -> Normalized;
+
 } // namespace fastmpc::abp
\ No newline at end of file
@@ -1,10 +1,28 @@
 #include "fastmpc/abp/function/abp_compare.h"
 #include "fastmpc/abp/function/abp_binary.h"
+#include "fastmpc/abp/function/abp_constant.h"
 #include "fastmpc/abp/function/abp_unary.h"
+#include <optional>
 
 namespace fastmpc::abp {
 
     namespace {
+        // left < right when the ranges of the operands decide it
+        auto known_less(ABPBuilder &builder, OpHandle left, OpHandle right) -> std::optional<bool> {
+            auto &context = builder.context();
+            auto left_range  = context.range(left);
+            auto right_range = context.range(right);
+            if (left_range.upper < right_range.lower)
+                return true;
+            if (left_range.lower >= right_range.upper)
+                return false;
+            return std::nullopt;
+        }
+
+        auto known_constant(ABPBuilder &builder, OpHandle like, bool value) -> OpHandle {
+            return constant_like(builder, like, uint64_t{value});
+        }
+
         auto msb(ABPBuilder &builder, OpHandle operand) {
             return builder.shift_right(builder.a2b(operand), 63);
         }
@@ -19,6 +37,8 @@ namespace fastmpc::abp {
     }
 
     auto isEqual(ABPBuilder &builder, OpHandle left, OpHandle right) -> OpHandle {
+        if (known_less(builder, left, right) == true || known_less(builder, right, left) == true)
+            return known_constant(builder, left, false);
         auto not_less    = builder.not_b(less_b(builder, left, right));
         auto not_greater = builder.not_b(greater_b(builder, left, right));
         auto result_b    = builder.and_bb(not_less, not_greater);
@@ -26,14 +46,20 @@ namespace fastmpc::abp {
     }
 
     auto isLess(ABPBuilder &builder, OpHandle left, OpHandle right) -> OpHandle {
+        if (auto known = known_less(builder, left, right))
+            return known_constant(builder, left, *known);
         return builder.b2a(less_b(builder, left, right), 0);
     }
 
     auto isGreater(ABPBuilder &builder, OpHandle left, OpHandle right) -> OpHandle {
+        if (auto known = known_less(builder, right, left))
+            return known_constant(builder, left, *known);
         return builder.b2a(greater_b(builder, left, right), 0);
     }
 
     auto isGEQ(ABPBuilder &builder, OpHandle left, OpHandle right) -> OpHandle {
+        if (auto known = known_less(builder, left, right))
+            return known_constant(builder, left, !*known);
         auto not_less = builder.not_b(less_b(builder, left, right));
         return builder.b2a(not_less, 0);
     }
@@ -45,6 +71,12 @@ namespace fastmpc::abp {
     }
 
     auto maximize(ABPBuilder &builder, OpHandle left, OpHandle right) -> OpHandle {
+        // no selection when one operand is never below the other
+        auto &context = builder.context();
+        if (context.range(right).upper <= context.range(left).lower)
+            return left;
+        if (context.range(left).upper <= context.range(right).lower)
+            return right;
         auto which = isGreater(builder, left, right);
         return selectOne(builder, which, left, right);
     }
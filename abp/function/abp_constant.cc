@@ -48,6 +48,24 @@ namespace fastmpc::abp {
         return builder.constant(handle, type);
     }
 
+    namespace {
+        auto broadcast_like(ABPBuilder &builder, OpHandle x, OpHandle value) {
+            auto &context = builder.context();
+            auto x_shape = context.type(x).shape;
+            if (!context.shape(x_shape).empty())
+                value = builder.broadcast(value, {}, x_shape);
+            return value;
+        }
+    }
+
+    auto constant_like(ABPBuilder &builder, OpHandle x, float value) -> OpHandle {
+        return broadcast_like(builder, x, constant(builder, value));
+    }
+
+    auto constant_like(ABPBuilder &builder, OpHandle x, uint64_t value) -> OpHandle {
+        return broadcast_like(builder, x, constant(builder, value));
+    }
+
     auto iota(ABPBuilder &builder, size_t iota_dimension, Shape &&shape) -> OpHandle {
         size_t n = shape[iota_dimension];
         vector <uint64_t> data(n);
@@ -10,5 +10,9 @@ namespace fastmpc::abp {
     auto constant(ABPBuilder &builder, vector <float> &&value, Shape &&shape)    -> OpHandle;
     auto constant(ABPBuilder &builder, vector <uint64_t> &&value, Shape &&shape) -> OpHandle;
     auto iota(ABPBuilder &builder, size_t iota_dimension, Shape &&shape)         -> OpHandle;
+
+    // scalar constant broadcast to the shape of `x`
+    auto constant_like(ABPBuilder &builder, OpHandle x, float value)    -> OpHandle;
+    auto constant_like(ABPBuilder &builder, OpHandle x, uint64_t value) -> OpHandle;
     
 }
\ No newline at end of file
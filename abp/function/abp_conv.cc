@@ -0,0 +1,211 @@
+#include "fastmpc/abp/function/abp_conv.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include <numeric>
+
+#include "fastmpc/abp/function/abp_binary.h"
+#include "fastmpc/abp/function/abp_constant.h"
+#include "fastmpc/abp/function/abp_reduce.h"
+
+namespace fastmpc::abp {
+
+namespace {
+
+auto at(const std::vector<size_t> &values, size_t i, size_t fallback)
+    -> size_t {
+  return values.empty() ? fallback : values[i];
+}
+
+auto product(const Shape &shape, size_t begin, size_t end) -> size_t {
+  return std::accumulate(shape.begin() + begin, shape.begin() + end, size_t{1},
+                         std::multiplies<>());
+}
+
+// public raw `value` of the kind and fixed point of x
+auto fill_like(ABPBuilder &builder, OpHandle x, int64_t value, Shape shape)
+    -> OpHandle {
+  auto type = builder.context().type(x);
+  Type fill_type{
+      .kind = TypeKind::kFixed64,
+      .fixed_point = type.fixed_point,
+      .shape = builder.push(Shape{}),
+  };
+  DenseValue dense_value(1);
+  dense_value[0] = static_cast<uint64_t>(value);
+  auto fill = builder.constant(builder.push(std::move(dense_value)), fill_type);
+  auto result = builder.broadcast(fill, {}, builder.push(std::move(shape)));
+  if (type.kind == TypeKind::kArithFixed64) {
+    result = builder.p2a(result);
+  }
+  return result;
+}
+
+// x padded with raw `value`, padding[i] applies to dimension first + i
+auto pad(ABPBuilder &builder, OpHandle x,
+         const std::vector<std::pair<size_t, size_t>> &padding, size_t first,
+         int64_t value) -> OpHandle {
+  for (size_t i = 0; i < padding.size(); i++) {
+    auto [low, high] = padding[i];
+    if (low == 0 && high == 0) {
+      continue;
+    }
+    auto shape = builder.context().shape(x);
+    std::vector<OpHandle> parts;
+    if (low != 0) {
+      shape[first + i] = low;
+      parts.push_back(fill_like(builder, x, value, shape));
+    }
+    parts.push_back(x);
+    if (high != 0) {
+      shape[first + i] = high;
+      parts.push_back(fill_like(builder, x, value, shape));
+    }
+    x = builder.concate(std::move(parts), first + i);
+  }
+  return x;
+}
+
+// shape of the window positions in a padded x, window[i] and the entries of
+// `conv` apply to dimension first + i
+auto output_shape(const Shape &padded, const Shape &window,
+                  const ConvWindow &conv, size_t first) -> Shape {
+  Shape result = padded;
+  for (size_t i = 0; i < window.size(); i++) {
+    size_t extent = (window[i] - 1) * at(conv.dilation, i, 1) + 1;
+    assert(padded[first + i] >= extent);
+    result[first + i] =
+        (padded[first + i] - extent) / at(conv.strides, i, 1) + 1;
+  }
+  return result;
+}
+
+// One strided view of a padded x per tap of the window, each of the output
+// shape. A tap that covers all of x is x itself.
+auto taps(ABPBuilder &builder, OpHandle x, const Shape &window,
+          const ConvWindow &conv, size_t first) -> std::vector<OpHandle> {
+  auto shape = builder.context().shape(x);
+  size_t rank = shape.size();
+  assert(first + window.size() <= rank);
+  auto outputs = output_shape(shape, window, conv, first);
+  size_t count = product(window, 0, window.size());
+
+  std::vector<OpHandle> result;
+  for (size_t tap = 0; tap < count; tap++) {
+    DenseSizeT start(rank, 0);
+    DenseSizeT end(rank);
+    DenseSizeT stride(rank, 1);
+    std::copy(shape.begin(), shape.end(), end.begin());
+    bool whole = true;
+    // the last dimension of the window runs fastest, as in the kernel
+    for (size_t i = window.size(), rest = tap; i-- > 0; rest /= window[i]) {
+      size_t d = first + i;
+      size_t step = at(conv.strides, i, 1);
+      start[d] = rest % window[i] * at(conv.dilation, i, 1);
+      end[d] = start[d] + (outputs[d] - 1) * step + 1;
+      stride[d] = step;
+      whole = whole && start[d] == 0 && end[d] == shape[d] && step == 1;
+    }
+    result.push_back(whole ? x
+                           : builder.slice(x, std::move(start), std::move(end),
+                                           std::move(stride)));
+  }
+  return result;
+}
+
+// Lowest raw value below the range of x whose differences to x stay within
+// the ring, padding with it never wins a maximum.
+auto lowest_below(ABPBuilder &builder, OpHandle x) -> int64_t {
+  auto &context = builder.context();
+  auto lowest = std::ldexp(context.range(x).lower, context.type(x).fixed_point);
+  return static_cast<int64_t>(std::max(lowest - 1, -std::ldexp(1.0, 62)));
+}
+
+} // namespace
+
+auto im2col(ABPBuilder &builder, OpHandle x, const Shape &window,
+            const ConvWindow &conv) -> OpHandle {
+  x = pad(builder, x, conv.padding, 1, 0);
+  auto shape = builder.context().shape(x);
+  size_t rank = shape.size();
+  assert(window.size() + 2 == rank);
+  auto columns = taps(builder, x, window, conv, 1);
+  auto outputs = builder.context().shape(columns[0]);
+  size_t count = columns.size();
+  auto patches = count == 1 ? columns[0]
+                            : builder.concate(std::move(columns), rank - 1);
+  Shape matrix{product(outputs, 0, rank - 1), count * shape[rank - 1]};
+  return builder.reshape(patches, builder.push(std::move(matrix)));
+}
+
+auto convolution(ABPBuilder &builder, OpHandle x, OpHandle kernel,
+                 const ConvWindow &conv) -> OpHandle {
+  auto &context = builder.context();
+  auto x_shape = context.shape(x);
+  auto kernel_shape = context.shape(kernel);
+  size_t spatial = x_shape.size() - 2;
+  assert(kernel_shape.size() == spatial + 2);
+  assert(kernel_shape[spatial] == x_shape.back());
+
+  Shape window(kernel_shape.begin(), kernel_shape.begin() + spatial);
+  auto patches = im2col(builder, x, window, conv);
+  size_t features = kernel_shape.back();
+  Shape matrix{context.shape(patches)[1], features};
+  auto weights = builder.reshape(kernel, builder.push(std::move(matrix)));
+  // secret patches and a public kernel multiply locally
+  auto result = dot_general(builder, patches, weights);
+
+  for (size_t i = 0; i < spatial; i++) {
+    if (i < conv.padding.size()) {
+      x_shape[i + 1] += conv.padding[i].first + conv.padding[i].second;
+    }
+  }
+  auto shape = output_shape(x_shape, window, conv, 1);
+  shape.back() = features;
+  return builder.reshape(result, builder.push(std::move(shape)));
+}
+
+auto max_pool(ABPBuilder &builder, OpHandle x, const Shape &window,
+              const ConvWindow &conv) -> OpHandle {
+  auto range = builder.context().range(x);
+  x = pad(builder, x, conv.padding, 0, lowest_below(builder, x));
+  auto views = taps(builder, x, window, conv, 0);
+  auto shape = builder.context().shape(views[0]);
+  if (views.size() == 1) {
+    return views[0];
+  }
+  // the taps of every window side by side in the last dimension
+  Shape column = shape;
+  column.push_back(1);
+  auto column_shape = builder.push(std::move(column));
+  for (auto &view : views) {
+    view = builder.reshape(view, column_shape);
+  }
+  auto stacked = builder.concate(std::move(views), shape.size());
+  auto result = reduce_max(builder, stacked, {shape.size()});
+  builder.assume(result, range);
+  return result;
+}
+
+auto sum_pool(ABPBuilder &builder, OpHandle x, const Shape &window,
+              const ConvWindow &conv) -> OpHandle {
+  x = pad(builder, x, conv.padding, 0, 0);
+  auto views = taps(builder, x, window, conv, 0);
+  auto result = views[0];
+  for (size_t i = 1; i < views.size(); i++) {
+    result = add(builder, result, views[i]);
+  }
+  return result;
+}
+
+auto avg_pool(ABPBuilder &builder, OpHandle x, const Shape &window,
+              const ConvWindow &conv) -> OpHandle {
+  auto sum = sum_pool(builder, x, window, conv);
+  auto count = product(window, 0, window.size());
+  auto reciprocal = constant_like(builder, sum, 1.f / static_cast<float>(count));
+  return multiply(builder, sum, reciprocal);
+}
+
+} // namespace fastmpc::abp
\ No newline at end of file
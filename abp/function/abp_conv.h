@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "fastmpc/abp/dialect/abp_builder.h"
+
+namespace fastmpc::abp {
+
+// Window of a convolution, one entry per spatial dimension, or of a pooling,
+// one entry per dimension. Empty vectors mean strides and dilations of 1 and
+// no padding.
+struct ConvWindow {
+  std::vector<size_t> strides;
+  // zeros before and after every spatial dimension
+  std::vector<std::pair<size_t, size_t>> padding;
+  // distance between the taps of the kernel
+  std::vector<size_t> dilation;
+};
+
+// Patches of x [batch, spatial..., feature] as the rows of a matrix
+// [batch * output spatial..., window... * feature]. Every patch is gathered
+// by one strided slice per kernel tap, so x is copied once per tap and a
+// window of 1 is x itself.
+auto im2col(ABPBuilder &builder, OpHandle x, const Shape &window,
+            const ConvWindow &conv) -> OpHandle;
+
+// Convolution of x [batch, spatial..., feature] with the kernel
+// [window..., feature, output feature] as one matmul of the im2col patches,
+// the result is [batch, output spatial..., output feature]. A public kernel
+// is applied to the shares locally.
+auto convolution(ABPBuilder &builder, OpHandle x, OpHandle kernel,
+                 const ConvWindow &conv = {}) -> OpHandle;
+
+// Poolings over the windows of x, `window` and the entries of `conv` cover
+// every dimension of x. Each tap of the window is one strided view of x with
+// all window positions, the views are reduced elementwise.
+//
+// Maximum of every window. The taps are stacked in a last dimension and
+// reduced by reduce_max, one batched comparison per level for all windows.
+// Padding is below the range of x and never wins.
+auto max_pool(ABPBuilder &builder, OpHandle x, const Shape &window,
+              const ConvWindow &conv = {}) -> OpHandle;
+// Sum of every window with zero padding, local to every party.
+auto sum_pool(ABPBuilder &builder, OpHandle x, const Shape &window,
+              const ConvWindow &conv = {}) -> OpHandle;
+// sum_pool times the public 1 / taps, a single truncation. Padding counts
+// toward the mean as zeros.
+auto avg_pool(ABPBuilder &builder, OpHandle x, const Shape &window,
+              const ConvWindow &conv = {}) -> OpHandle;
+
+} // namespace fastmpc::abp
\ No newline at end of file
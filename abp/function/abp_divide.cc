@@ -2,31 +2,72 @@
 
 #include <cassert>
 #include <cstdlib>
+#include <optional>
 #include <type_traits>
 
 #include "fastmpc/abp/dialect/abp_ops.h"
 #include "fastmpc/abp/function/abp_binary.h"
 #include "fastmpc/abp/function/abp_circuit.h"
 #include "fastmpc/abp/function/abp_compare.h"
+#include "fastmpc/abp/function/abp_constant.h"
 #include "fastmpc/abp/function/abp_unary.h"
 
 namespace fastmpc::abp {
 
 namespace {
 
-auto divide_xa(ABPBuilder &builder, OpHandle x, OpHandle y) -> OpHandle {
-  auto is_negative = msb(builder, y);
-  auto y_abs = selectOne(builder, is_negative, negate(builder, y), y);
-  auto y_msb = highest_one_bit(builder, y_abs);
-  auto factor = bit_reverse(builder, y_msb, 2 * builder.fixed_point());
+// The linear guess 2.9142 - 2d is within 2^-3.5 of 1/d on [0.5, 1), every
+// Goldschmidt iteration doubles the number of correct bits.
+auto goldschmidt_iterations(uint8_t precision) -> size_t {
+  size_t iterations = 0;
+  for (double bits = 3.5; bits < precision; bits *= 2) {
+    iterations++;
+  }
+  return iterations;
+}
+
+auto divide_xa(ABPBuilder &builder, OpHandle x, OpHandle y,
+               uint8_t precision) -> OpHandle {
+  // x / y = sigma * x / |y| with sigma = 1 - 2 * msb(y). The sign bit is
+  // computed once and applied as a multiplication instead of two selectOne.
+  // sigma is applied to x last, so that truncations on the x chain keep the
+  // bias of the old implementation.
+  // A divisor of known sign, such as a sum of exponentials, needs no sign bit.
+  auto y_range = builder.context().range(y);
+  std::optional<OpHandle> sigma;
+  if (y_range.is_negative()) {
+    y = negate(builder, y);
+  } else if (!y_range.is_non_negative()) {
+    auto is_negative = msb(builder, y);
+    auto one = constant_like(builder, is_negative, uint64_t{1});
+    sigma = subtract(builder, one, add(builder, is_negative, is_negative));
+    y = multiply(builder, y, *sigma);
+  }
+  builder.assume(y, Range{0, y_range.magnitude()});
+
+  auto factor = normalize(builder, y).factor;
   x = multiply(builder, x, factor);
-  y = multiply(builder, y_abs, factor);
-  for (size_t i = 0; i < 5; i++) {
-    x = subtract(builder, add(builder, x, x), multiply(builder, x, y));
-    if (i + 1 != 5)
-      y = subtract(builder, add(builder, y, y), multiply(builder, y, y));
+  y = multiply(builder, y, factor);
+
+  auto guess = subtract(builder, constant_like(builder, y, 2.9142f),
+                        add(builder, y, y));
+  x = multiply(builder, x, guess);
+  y = multiply(builder, y, guess);
+
+  // numerator and denominator only depend on the previous iteration, so both
+  // multiplications of an iteration share one round
+  auto two = constant_like(builder, y, 2.0f);
+  size_t iterations = goldschmidt_iterations(precision);
+  for (size_t i = 0; i < iterations; i++) {
+    auto f = subtract(builder, two, y);
+    x = multiply(builder, x, f);
+    if (i + 1 != iterations)
+      y = multiply(builder, y, f);
+  }
+  if (sigma) {
+    return multiply(builder, x, *sigma);
   }
-  return selectOne(builder, is_negative, negate(builder, x), x);
+  return y_range.is_negative() ? negate(builder, x) : x;
 }
 
 auto divide_xp(ABPBuilder &builder, OpHandle x, OpHandle y) -> OpHandle {
@@ -35,11 +76,16 @@ auto divide_xp(ABPBuilder &builder, OpHandle x, OpHandle y) -> OpHandle {
 } // namespace
 
 auto divide(ABPBuilder &builder, OpHandle x, OpHandle y) -> OpHandle {
+  return divide(builder, x, y, builder.fixed_point());
+}
+
+auto divide(ABPBuilder &builder, OpHandle x, OpHandle y,
+            uint8_t precision) -> OpHandle {
   auto &context = builder.context();
   assert(context.type(x).kind != TypeKind::kBitArray64);
   switch (context.type(y).kind) {
   case TypeKind::kArithFixed64:
-    return divide_xa(builder, x, y);
+    return divide_xa(builder, x, y, precision);
   case TypeKind::kFixed64:
     return divide_xp(builder, x, y);
   case TypeKind::kBitArray64:
@@ -6,4 +6,9 @@ namespace fastmpc::abp {
 
 auto divide(ABPBuilder &builder, OpHandle x, OpHandle y) -> OpHandle;
 
+// Division whose result is accurate to about `precision` fractional bits. A
+// secret divisor costs ceil(log2(precision / 3.5)) Goldschmidt rounds.
+auto divide(ABPBuilder &builder, OpHandle x, OpHandle y,
+            uint8_t precision) -> OpHandle;
+
 }
\ No newline at end of file
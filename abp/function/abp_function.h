@@ -3,8 +3,13 @@
 #include "fastmpc/abp/function/abp_circuit.h"
 #include "fastmpc/abp/function/abp_compare.h"
 #include "fastmpc/abp/function/abp_constant.h"
+#include "fastmpc/abp/function/abp_conv.h"
 #include "fastmpc/abp/function/abp_divide.h"
 #include "fastmpc/abp/function/abp_log2.h"
+#include "fastmpc/abp/function/abp_lookup.h"
+#include "fastmpc/abp/function/abp_poly.h"
 #include "fastmpc/abp/function/abp_reduce.h"
+#include "fastmpc/abp/function/abp_sqrt.h"
+#include "fastmpc/abp/function/abp_top_k.h"
 #include "fastmpc/abp/function/abp_unary.h"
 #include "fastmpc/abp/function/abp_nn.h"
\ No newline at end of file
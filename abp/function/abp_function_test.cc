@@ -1,8 +1,11 @@
 #include "gtest/gtest.h"
 
+#include <algorithm>
 #include <cmath>
+#include <type_traits>
 #include <vector>
 
+#include "fastmpc/abp/analysis/abp_cost.h"
 #include "fastmpc/abp/dialect/abp_types.h"
 #include "fastmpc/abp/executor/abp_executor.h"
 #include "fastmpc/abp/function/abp_function.h"
@@ -30,8 +33,8 @@ public:
   }
 
   auto arg_int(size_t index, uint64_t value, bool is_public) -> OpHandle {
-    eager::Tensor tensor;
-    *tensor.data() = value;
+    auto tensor = eager::Tensor::with_shape({1});
+    tensor.data()[0] = value;
     executor_->input(index) = tensor;
     Type type{
         .kind = is_public ? TypeKind::kFixed64 : TypeKind::kArithFixed64,
@@ -41,6 +44,22 @@ public:
     return builder_->input(index, type);
   }
 
+  // a secret tensor of `values` in row-major order
+  auto arg_tensor(size_t index, const std::vector<float> &values, Shape shape)
+      -> OpHandle {
+    auto tensor = eager::Tensor::with_shape(shape);
+    for (size_t i = 0; i < values.size(); i++) {
+      tensor.data()[i] = raw(values[i]);
+    }
+    executor_->input(index) = tensor;
+    Type type{
+        .kind = TypeKind::kArithFixed64,
+        .fixed_point = builder_->fixed_point(),
+        .shape = builder_->push(std::move(shape)),
+    };
+    return builder_->input(index, type);
+  }
+
   auto output_float(size_t index = 0) {
     return decode(executor_->output(index).data()[0]);
   }
@@ -50,12 +69,15 @@ public:
 private:
   auto encode(float value) -> eager::Tensor {
     eager::Tensor tensor;
-    int scalar = 1 << builder_->fixed_point();
-    *tensor.data() =
-        static_cast<uint64_t>(static_cast<int64_t>(value * scalar));
+    *tensor.data() = raw(value);
     return tensor;
   }
 
+  auto raw(float value) -> uint64_t {
+    int scalar = 1 << builder_->fixed_point();
+    return static_cast<uint64_t>(static_cast<int64_t>(value * scalar));
+  }
+
   auto decode(uint64_t value) -> float {
     int scalar = 1 << builder_->fixed_point();
     return static_cast<float>(static_cast<int64_t>(value)) / scalar;
@@ -65,6 +87,11 @@ private:
   ABPExecutor *executor_;
 };
 
+// two rows of five with a tie for the maximum and a negative one
+auto max_rows(Environment &env) -> OpHandle {
+  return env.arg_tensor(0, {3, -7, 12, 12, 5, -2, -9, -1, -8, -2}, {2, 5});
+}
+
 } // namespace
 
 #define SETUP(FIXED_POINT, INPUT_SIZE, OUTPUT_SIZE)                            \
@@ -288,6 +315,16 @@ TEST(abp_function_test, divide_pa) {
   EXPECT_NEAR(env.output_float(), 0.15384615384615385, 1e-4);
 }
 
+TEST(abp_function_test, divide_aa_precision) {
+  SETUP(15, 2, 1);
+  auto left = env.arg_float(0, -1.f, false);
+  auto right = env.arg_float(1, 3.f, false);
+  auto result = divide(builder, left, right, 8);
+  builder.output(result, 0);
+  executor.run();
+  EXPECT_NEAR(env.output_float(), -1.f / 3, 1.f / 256);
+}
+
 TEST(abp_function_test, exp) {
   SETUP(18, 1, 1);
   auto operand = env.arg_float(0, 0.5f, false);
@@ -297,6 +334,41 @@ TEST(abp_function_test, exp) {
   EXPECT_NEAR(env.output_float(), std::exp(0.5), 1e-3);
 }
 
+TEST(abp_function_test, exp_range_reduction) {
+  SETUP(18, 3, 3);
+  const float inputs[] = {0.5f, -3.25f, 7.125f};
+  for (size_t i = 0; i < 3; i++) {
+    auto operand = env.arg_float(i, inputs[i], false);
+    auto result = exp(builder, operand, ExpMode::kRangeReduction);
+    builder.output(result, i);
+  }
+  executor.run();
+  for (size_t i = 0; i < 3; i++) {
+    float expected = std::exp(inputs[i]);
+    EXPECT_NEAR(env.output_float(i), expected, 1e-3 * expected + 1e-4);
+  }
+}
+
+TEST(abp_function_test, thermometer_count) {
+  SETUP(15, 1, 1);
+  auto operand = env.arg_int(0, (uint64_t{1} << 37) - 1, false);
+  auto result = thermometer_count(builder, builder.a2b(operand));
+  builder.output(result, 0);
+  executor.run();
+  EXPECT_EQ(env.output_int(), 37);
+}
+
+TEST(abp_function_test, normalize) {
+  SETUP(15, 1, 2);
+  auto operand = env.arg_float(0, 3.f, false);
+  auto normalized = normalize(builder, operand);
+  builder.output(multiply(builder, operand, normalized.factor), 0);
+  builder.output(normalized.exponent, 1);
+  executor.run();
+  EXPECT_NEAR(env.output_float(0), 0.75, 1e-4);
+  EXPECT_EQ(static_cast<int64_t>(env.output_int(1)), 2);
+}
+
 TEST(abp_function_test, log2) {
   SETUP(15, 1, 1);
   auto operand = env.arg_float(0, 1.75f, false);
@@ -358,4 +430,811 @@ TEST(abp_function_test, reduce_1) {
   Shape expect_shape{};
   EXPECT_EQ(output.shape(), expect_shape);
   EXPECT_EQ(output.data()[0], 4950);
+}
+
+TEST(abp_function_test, dot_product) {
+  ABPContext context;
+  ABPBuilder builder(context, 15);
+  ABPExecutor executor(context, 2, 1);
+
+  const float left_values[] = {0.5f, -1.25f, 2.f, 1.5f, 0.25f, -0.75f};
+  const float right_values[] = {1.f, 0.5f, -0.5f, 2.f, -4.f, 1.f};
+  auto left_tensor = eager::Tensor::with_shape({2, 3});
+  auto right_tensor = eager::Tensor::with_shape({2, 3});
+  for (size_t i = 0; i < 6; i++) {
+    left_tensor.data()[i] =
+        static_cast<uint64_t>(static_cast<int64_t>(left_values[i] * (1 << 15)));
+    right_tensor.data()[i] = static_cast<uint64_t>(
+        static_cast<int64_t>(right_values[i] * (1 << 15)));
+  }
+  executor.input(0) = left_tensor;
+  executor.input(1) = right_tensor;
+
+  auto type = Type{
+      .kind = TypeKind::kArithFixed64,
+      .fixed_point = 15,
+      .shape = builder.push(Shape{2, 3}),
+  };
+  auto left = builder.input(0, type);
+  auto right = builder.input(1, type);
+  auto result = dot_product(builder, left, right, 1);
+  builder.output(result, 0);
+
+  executor.run();
+  auto output = executor.output(0);
+
+  Shape expect_shape{2};
+  EXPECT_EQ(output.shape(), expect_shape);
+  auto decode = [&](size_t i) {
+    return static_cast<float>(static_cast<int64_t>(output.data()[i])) /
+           (1 << 15);
+  };
+  EXPECT_NEAR(decode(0), 0.5f - 0.625f - 1.f, 1e-4);
+  EXPECT_NEAR(decode(1), 3.f - 1.f - 0.75f, 1e-4);
+}
+
+TEST(abp_function_test, rsqrt) {
+  SETUP(18, 4, 4);
+  const float inputs[] = {4.f, 0.3f, 2.f, 123.456f};
+  for (size_t i = 0; i < 4; i++) {
+    auto operand = env.arg_float(i, inputs[i], false);
+    builder.output(rsqrt(builder, operand), i);
+  }
+  executor.run();
+  for (size_t i = 0; i < 4; i++) {
+    EXPECT_NEAR(env.output_float(i), 1 / std::sqrt(inputs[i]), 1e-4);
+  }
+}
+
+// small results are within one unit of the fixed point
+TEST(abp_function_test, rsqrt_large) {
+  SETUP(18, 4, 4);
+  const float inputs[] = {400.f, 1500.f, 6000.f, 130000.f};
+  for (size_t i = 0; i < 4; i++) {
+    auto operand = env.arg_float(i, inputs[i], false);
+    builder.output(rsqrt(builder, operand), i);
+  }
+  executor.run();
+  for (size_t i = 0; i < 4; i++) {
+    EXPECT_NEAR(env.output_float(i), 1 / std::sqrt(inputs[i]), 1.f / (1 << 18));
+  }
+}
+
+TEST(abp_function_test, sqrt) {
+  SETUP(18, 1, 1);
+  auto operand = env.arg_float(0, 2.f, false);
+  builder.output(sqrt(builder, operand), 0);
+  executor.run();
+  EXPECT_NEAR(env.output_float(), std::sqrt(2.f), 1e-4);
+}
+
+// rsqrt against 1 / y after Heron's iterations y = (y + x / y) / 2
+TEST(abp_function_test, rsqrt_cost) {
+  SETUP(18, 1, 0);
+  auto operand = env.arg_float(0, 2.f, false);
+  auto result = rsqrt(builder, operand);
+
+  auto half = constant(builder, 0.5f);
+  auto naive = constant(builder, 1.f);
+  for (size_t i = 0; i < 5; i++) {
+    auto sum = add(builder, naive, divide(builder, operand, naive));
+    naive = multiply(builder, sum, half);
+  }
+  naive = divide(builder, constant(builder, 1.f), naive);
+
+  auto cost = estimate_cost(context, result);
+  auto naive_cost = estimate_cost(context, naive);
+  RecordProperty("rounds", static_cast<int>(cost.rounds));
+  RecordProperty("bytes", static_cast<int>(cost.bytes));
+  RecordProperty("naive_rounds", static_cast<int>(naive_cost.rounds));
+  RecordProperty("naive_bytes", static_cast<int>(naive_cost.bytes));
+  EXPECT_LT(cost.rounds, naive_cost.rounds);
+  EXPECT_LT(cost.bytes, naive_cost.bytes);
+}
+
+TEST(abp_function_test, layer_norm) {
+  SETUP(16, 3, 1);
+  const float x_values[] = {1.f, 2.f, 3.f, 4.f, -0.5f, 0.25f, 2.f, -3.f};
+  const float gamma_values[] = {1.f, 0.5f, -2.f, 1.5f};
+  const float beta_values[] = {0.f, 1.f, -0.25f, 0.5f};
+  auto encode = [](const float *values, size_t size, Shape shape) {
+    auto tensor = eager::Tensor::with_shape(shape);
+    for (size_t i = 0; i < size; i++) {
+      tensor.data()[i] =
+          static_cast<uint64_t>(static_cast<int64_t>(values[i] * (1 << 16)));
+    }
+    return tensor;
+  };
+  executor.input(0) = encode(x_values, 8, {2, 4});
+  executor.input(1) = encode(gamma_values, 4, {4});
+  executor.input(2) = encode(beta_values, 4, {4});
+
+  auto x = builder.input(0, Type{
+                                .kind = TypeKind::kArithFixed64,
+                                .fixed_point = 16,
+                                .shape = builder.push(Shape{2, 4}),
+                            });
+  auto param_type = Type{
+      .kind = TypeKind::kFixed64,
+      .fixed_point = 16,
+      .shape = builder.push(Shape{4}),
+  };
+  auto gamma = builder.input(1, param_type);
+  auto beta = builder.input(2, param_type);
+  builder.output(layer_norm(builder, x, gamma, beta, 1), 0);
+  executor.run();
+  auto output = executor.output(0);
+
+  Shape expect_shape{2, 4};
+  EXPECT_EQ(output.shape(), expect_shape);
+  for (size_t row = 0; row < 2; row++) {
+    const float *values = x_values + 4 * row;
+    float mean = (values[0] + values[1] + values[2] + values[3]) / 4;
+    float variance = 0;
+    for (size_t i = 0; i < 4; i++) {
+      variance += (values[i] - mean) * (values[i] - mean) / 4;
+    }
+    for (size_t i = 0; i < 4; i++) {
+      float expect = (values[i] - mean) / std::sqrt(variance + 1e-5f) *
+                         gamma_values[i] +
+                     beta_values[i];
+      float actual =
+          static_cast<float>(static_cast<int64_t>(output.data()[4 * row + i])) /
+          (1 << 16);
+      EXPECT_NEAR(actual, expect, 1e-3);
+    }
+  }
+}
+
+// rows of a transformer width, the second one with a larger variance
+TEST(abp_function_test, layer_norm_wide) {
+  SETUP(16, 3, 1);
+  const size_t n = 768;
+  std::vector<double> x_values(2 * n), gamma_values(n), beta_values(n);
+  auto raw = [](double value) {
+    return static_cast<int64_t>(value * (1 << 16));
+  };
+  auto x_tensor = eager::Tensor::with_shape({2, n});
+  auto gamma_tensor = eager::Tensor::with_shape({n});
+  auto beta_tensor = eager::Tensor::with_shape({n});
+  for (size_t i = 0; i < n; i++) {
+    double wave = 2 * std::sin(0.37 * i) + 0.5 * std::cos(1.3 * i);
+    for (size_t row = 0; row < 2; row++) {
+      auto value = raw(wave * (row == 0 ? 1 : 8) + 0.25 + 3 * row);
+      x_tensor.data()[row * n + i] = static_cast<uint64_t>(value);
+      x_values[row * n + i] = static_cast<double>(value) / (1 << 16);
+    }
+    auto gamma = raw(1 + 0.5 * std::sin(0.11 * i));
+    auto beta = raw(0.25 * std::cos(0.07 * i));
+    gamma_tensor.data()[i] = static_cast<uint64_t>(gamma);
+    beta_tensor.data()[i] = static_cast<uint64_t>(beta);
+    gamma_values[i] = static_cast<double>(gamma) / (1 << 16);
+    beta_values[i] = static_cast<double>(beta) / (1 << 16);
+  }
+  executor.input(0) = x_tensor;
+  executor.input(1) = gamma_tensor;
+  executor.input(2) = beta_tensor;
+
+  auto x = builder.input(0, Type{
+                                .kind = TypeKind::kArithFixed64,
+                                .fixed_point = 16,
+                                .shape = builder.push(Shape{2, n}),
+                            });
+  auto param_type = Type{
+      .kind = TypeKind::kFixed64,
+      .fixed_point = 16,
+      .shape = builder.push(Shape{n}),
+  };
+  auto gamma = builder.input(1, param_type);
+  auto beta = builder.input(2, param_type);
+  builder.output(layer_norm(builder, x, gamma, beta, 1), 0);
+  executor.run();
+  auto output = executor.output(0);
+
+  for (size_t row = 0; row < 2; row++) {
+    const double *values = x_values.data() + n * row;
+    double mean = 0;
+    for (size_t i = 0; i < n; i++) {
+      mean += values[i] / n;
+    }
+    double variance = 0;
+    for (size_t i = 0; i < n; i++) {
+      variance += (values[i] - mean) * (values[i] - mean) / n;
+    }
+    for (size_t i = 0; i < n; i++) {
+      double expect = (values[i] - mean) / std::sqrt(variance + 1e-5) *
+                          gamma_values[i] +
+                      beta_values[i];
+      auto actual =
+          static_cast<double>(static_cast<int64_t>(output.data()[n * row + i])) /
+          (1 << 16);
+      EXPECT_NEAR(actual, expect, 5e-4);
+    }
+  }
+}
+
+// against Horner's rule, which needs one round per degree
+TEST(abp_function_test, polynomial) {
+  SETUP(18, 1, 1);
+  const std::vector<float> coefficients = {1.f, -2.f, 0.5f, 3.f, -0.25f, 0.125f};
+  auto operand = env.arg_float(0, 0.75f, false);
+  auto result = polynomial(builder, operand, coefficients);
+  builder.output(result, 0);
+
+  auto horner = constant(builder, coefficients.back());
+  for (size_t i = coefficients.size() - 1; i-- > 0;) {
+    horner = multiply(builder, horner, operand);
+    horner = add(builder, horner, constant(builder, coefficients[i]));
+  }
+  executor.run();
+
+  float expect = 0;
+  for (size_t i = coefficients.size(); i-- > 0;) {
+    expect = expect * 0.75f + coefficients[i];
+  }
+  EXPECT_NEAR(env.output_float(), expect, 1e-4);
+  EXPECT_LT(estimate_cost(context, result).rounds,
+            estimate_cost(context, horner).rounds);
+}
+
+TEST(abp_function_test, piecewise_poly) {
+  SETUP(18, 3, 3);
+  // -x^2 below -1, 1 - 2x^2 on [-1, 0.5), x^3 from 0.5 on
+  const float inputs[] = {-1.5f, 0.25f, 3.f};
+  const float expects[] = {-2.25f, 0.875f, 27.f};
+  for (size_t i = 0; i < 3; i++) {
+    auto operand = env.arg_float(i, inputs[i], false);
+    auto result = piecewise_poly(builder, operand, {-1.f, 0.5f},
+                                 {{0.f, 0.f, -1.f}, {1.f, 0.f, -2.f}, {0.f, 0.f, 0.f, 1.f}});
+    builder.output(result, i);
+  }
+  executor.run();
+  for (size_t i = 0; i < 3; i++) {
+    EXPECT_NEAR(env.output_float(i), expects[i], 1e-3);
+  }
+}
+
+TEST(abp_function_test, sigmoid_tanh_gelu) {
+  SETUP(18, 4, 12);
+  const float inputs[] = {-9.f, -0.5f, 0.7f, 2.2f};
+  for (size_t i = 0; i < 4; i++) {
+    auto operand = env.arg_float(i, inputs[i], false);
+    builder.output(sigmoid(builder, operand), i);
+    builder.output(tanh(builder, operand), 4 + i);
+    builder.output(gelu_piecewise(builder, operand), 8 + i);
+  }
+  executor.run();
+  for (size_t i = 0; i < 4; i++) {
+    float x = inputs[i];
+    EXPECT_NEAR(env.output_float(i), 1 / (1 + std::exp(-x)), 2e-3);
+    EXPECT_NEAR(env.output_float(4 + i), std::tanh(x), 4e-3);
+    EXPECT_NEAR(env.output_float(8 + i), x * (1 + std::erf(x / std::sqrt(2.f))) / 2, 2e-3);
+  }
+}
+
+TEST(abp_function_test, gelu_piecewise_cost) {
+  SETUP(18, 1, 0);
+  auto operand = env.arg_float(0, 1.f, false);
+  auto cost = estimate_cost(context, gelu_piecewise(builder, operand));
+  auto exp_cost = estimate_cost(context, gelu(builder, operand));
+  RecordProperty("rounds", static_cast<int>(cost.rounds));
+  RecordProperty("exp_rounds", static_cast<int>(exp_cost.rounds));
+  EXPECT_LT(cost.rounds, exp_cost.rounds);
+}
+
+TEST(abp_function_test, compare_known_range) {
+  SETUP(16, 3, 3);
+  auto x = env.arg_float(0, -3.f, false);
+  auto y = env.arg_float(1, 0.5f, false);
+  auto z = env.arg_float(2, -3.f, false);
+  builder.assume(x, Range{-4, 4});
+  builder.assume(y, Range{-4, 4});
+  // decided by the ranges, no comparison is built
+  auto known = isLess(builder, x, constant_like(builder, x, 8.f));
+  EXPECT_EQ(estimate_cost(context, known).rounds, 0u);
+  // the difference fits in 21 bits
+  auto narrow = isLess(builder, x, y);
+  auto wide = isLess(builder, z, y);
+  EXPECT_LT(estimate_cost(context, narrow).rounds,
+            estimate_cost(context, wide).rounds);
+  builder.output(known, 0);
+  builder.output(narrow, 1);
+  builder.output(isGreater(builder, x, y), 2);
+  executor.run();
+  EXPECT_EQ(env.output_int(0), 1);
+  EXPECT_EQ(env.output_int(1), 1);
+  EXPECT_EQ(env.output_int(2), 0);
+}
+
+TEST(abp_function_test, divide_known_sign) {
+  SETUP(16, 3, 2);
+  auto x = env.arg_float(0, -1.f, false);
+  auto y = env.arg_float(1, 3.f, false);
+  auto z = env.arg_float(2, 3.f, false);
+  builder.assume(y, Range{1, 8});
+  auto known = divide(builder, x, y);
+  auto unknown = divide(builder, x, z);
+  EXPECT_LT(estimate_cost(context, known).rounds,
+            estimate_cost(context, unknown).rounds);
+  builder.output(known, 0);
+  builder.output(divide(builder, x, builder.negate_a(y)), 1);
+  executor.run();
+  EXPECT_NEAR(env.output_float(0), -1.f / 3, 1e-4);
+  EXPECT_NEAR(env.output_float(1), 1.f / 3, 1e-4);
+}
+
+TEST(abp_function_test, reduce_max_strategies) {
+  SETUP(16, 1, 2);
+  auto x = max_rows(env);
+  // many rounds on a slow link, bytes on a thin one
+  const NetworkModel wan{.latency = 5e-2, .bandwidth = 1e8};
+  const NetworkModel thin{.latency = 0, .bandwidth = 1e6};
+  EXPECT_EQ(max_strategy(builder, x, wan), MaxStrategy::kAllPairs);
+  EXPECT_EQ(max_strategy(builder, x, thin), MaxStrategy::kTournament);
+
+  auto all_pairs = reduce_max(builder, x, {1}, wan);
+  auto tournament = reduce_max(builder, x, {1}, thin);
+  EXPECT_LT(estimate_cost(context, all_pairs).rounds,
+            estimate_cost(context, tournament).rounds);
+  builder.output(all_pairs, 0);
+  builder.output(tournament, 1);
+  executor.run();
+  for (size_t i = 0; i < 2; i++) {
+    auto output = executor.output(i);
+    Shape expect_shape{2};
+    EXPECT_EQ(output.shape(), expect_shape);
+    EXPECT_EQ(output.data()[0], uint64_t{12} << 16);
+    EXPECT_EQ(output.data()[1], static_cast<uint64_t>(int64_t{-1} << 16));
+  }
+}
+
+TEST(abp_function_test, top_k_and_argmax) {
+  SETUP(16, 1, 3);
+  auto x = max_rows(env);
+  auto top = top_k(builder, x, 3);
+  builder.output(top.values, 0);
+  builder.output(top.indices, 1);
+  builder.output(argmax(builder, x), 2);
+  executor.run();
+
+  Shape top_shape{2, 3};
+  EXPECT_EQ(executor.output(0).shape(), top_shape);
+  EXPECT_EQ(executor.output(1).shape(), top_shape);
+  const int64_t expect_values[] = {12, 12, 5, -1, -2, -2};
+  for (size_t i = 0; i < 6; i++) {
+    EXPECT_EQ(executor.output(0).data()[i],
+              static_cast<uint64_t>(expect_values[i] << 16));
+  }
+  // equal values may come in either order, their indices are compared as sets
+  auto indices = [&](size_t start, size_t end) {
+    std::vector<int64_t> result;
+    for (size_t i = start; i < end; i++) {
+      result.push_back(static_cast<int64_t>(executor.output(1).data()[i]) >> 16);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+  };
+  EXPECT_EQ(indices(0, 2), (std::vector<int64_t>{2, 3}));
+  EXPECT_EQ(indices(2, 3), (std::vector<int64_t>{4}));
+  EXPECT_EQ(indices(3, 4), (std::vector<int64_t>{2}));
+  EXPECT_EQ(indices(4, 6), (std::vector<int64_t>{0, 4}));
+  // the first of equal maxima
+  Shape argmax_shape{2};
+  EXPECT_EQ(executor.output(2).shape(), argmax_shape);
+  EXPECT_EQ(executor.output(2).data()[0], uint64_t{2} << 16);
+  EXPECT_EQ(executor.output(2).data()[1], uint64_t{2} << 16);
+}
+
+TEST(abp_function_test, softmax_clip) {
+  SETUP(16, 1, 2);
+  const float values[] = {1.5f, -0.5f, 2.f,   0.25f, -3.f, 1.f,
+                          -1.f, -2.5f, 0.5f, -0.75f, 3.f,  -4.f};
+  auto tensor = eager::Tensor::with_shape({2, 6});
+  for (size_t i = 0; i < 12; i++) {
+    tensor.data()[i] =
+        static_cast<uint64_t>(static_cast<int64_t>(values[i] * (1 << 16)));
+  }
+  executor.input(0) = tensor;
+  auto x = builder.input(0, Type{
+                                .kind = TypeKind::kArithFixed64,
+                                .fixed_point = 16,
+                                .shape = builder.push(Shape{2, 6}),
+                            });
+  builder.assume(x, Range{-4, 3});
+  auto with_max = softmax(builder, x, SoftmaxMode::kMax);
+  auto with_clip = softmax(builder, x, SoftmaxMode::kClip);
+  auto max_cost = estimate_cost(context, with_max);
+  auto clip_cost = estimate_cost(context, with_clip);
+  RecordProperty("max_rounds", static_cast<int>(max_cost.rounds));
+  RecordProperty("max_bytes", static_cast<int>(max_cost.bytes));
+  RecordProperty("clip_rounds", static_cast<int>(clip_cost.rounds));
+  RecordProperty("clip_bytes", static_cast<int>(clip_cost.bytes));
+  EXPECT_LT(clip_cost.rounds, max_cost.rounds);
+  EXPECT_LT(clip_cost.bytes, max_cost.bytes);
+  builder.output(with_max, 0);
+  builder.output(with_clip, 1);
+  executor.run();
+
+  float max_error = 0;
+  float clip_error = 0;
+  for (size_t row = 0; row < 2; row++) {
+    const float *logits = values + 6 * row;
+    float max_logit = *std::max_element(logits, logits + 6);
+    float sum = 0;
+    for (size_t i = 0; i < 6; i++) {
+      sum += std::exp(logits[i] - max_logit);
+    }
+    for (size_t i = 0; i < 6; i++) {
+      float expected = std::exp(logits[i] - max_logit) / sum;
+      auto decode = [&](size_t index) {
+        auto raw = executor.output(index).data()[6 * row + i];
+        return static_cast<float>(static_cast<int64_t>(raw)) / (1 << 16);
+      };
+      EXPECT_NEAR(decode(0), expected, 3e-3);
+      EXPECT_NEAR(decode(1), expected, 5e-3);
+      max_error = std::max(max_error, std::abs(decode(0) - expected));
+      clip_error = std::max(clip_error, std::abs(decode(1) - expected));
+    }
+  }
+  // in millionths
+  RecordProperty("max_error", static_cast<int>(max_error * 1e6f));
+  RecordProperty("clip_error", static_cast<int>(clip_error * 1e6f));
+}
+
+// a range far below the bound floors the row sums, which costs a comparison
+TEST(abp_function_test, softmax_clip_floor) {
+  SETUP(16, 2, 1);
+  const std::vector<float> values = {3.f, 1.f, -0.5f, 2.f};
+  auto narrow = env.arg_tensor(0, values, {1, 4});
+  auto wide = env.arg_tensor(1, values, {1, 4});
+  builder.assume(narrow, Range{-4, 3});
+  builder.assume(wide, Range{-40, 3});
+  auto unfloored = softmax(builder, narrow, SoftmaxMode::kClip);
+  auto floored = softmax(builder, wide, SoftmaxMode::kClip);
+  EXPECT_GT(estimate_cost(context, floored).rounds,
+            estimate_cost(context, unfloored).rounds);
+  builder.output(floored, 0);
+  executor.run();
+
+  float sum = 0;
+  for (auto value : values) {
+    sum += std::exp(value - 3.f);
+  }
+  for (size_t i = 0; i < 4; i++) {
+    auto raw = executor.output(0).data()[i];
+    EXPECT_NEAR(static_cast<float>(static_cast<int64_t>(raw)) / (1 << 16),
+                std::exp(values[i] - 3.f) / sum, 5e-3);
+  }
+}
+
+TEST(abp_function_test, convolution_im2col) {
+  SETUP(16, 3, 2);
+  // x [1, 3, 3, 1] and kernel [2, 2, 1, 2]
+  const float x_values[] = {1, -2, 3, 0.5f, 4, -1, 2, 0, -3};
+  const float kernel_values[] = {1, 0.5f, -1, 0, 2, 1, 0.25f, -2};
+  auto encode = [](const float *values, Shape shape) {
+    auto tensor = eager::Tensor::with_shape(std::move(shape));
+    for (size_t i = 0; i < tensor.num_elements(); i++) {
+      tensor.data()[i] =
+          static_cast<uint64_t>(static_cast<int64_t>(values[i] * (1 << 16)));
+    }
+    return tensor;
+  };
+  executor.input(0) = encode(x_values, {1, 3, 3, 1});
+  executor.input(1) = encode(kernel_values, {2, 2, 1, 2});
+  executor.input(2) = encode(kernel_values, {2, 2, 1, 2});
+  auto input = [&](size_t index, TypeKind kind, Shape shape) {
+    return builder.input(index, Type{
+                                    .kind = kind,
+                                    .fixed_point = 16,
+                                    .shape = builder.push(std::move(shape)),
+                                });
+  };
+  auto x = input(0, TypeKind::kArithFixed64, {1, 3, 3, 1});
+  auto secret_kernel = input(1, TypeKind::kArithFixed64, {2, 2, 1, 2});
+  auto public_kernel = input(2, TypeKind::kFixed64, {2, 2, 1, 2});
+  // one row of zeros below and one column of zeros to the right
+  const ConvWindow window{.padding = {{0, 1}, {0, 1}}};
+  auto with_secret = convolution(builder, x, secret_kernel, window);
+  auto with_public = convolution(builder, x, public_kernel, window);
+  EXPECT_LT(estimate_cost(context, with_public).rounds,
+            estimate_cost(context, with_secret).rounds);
+  builder.output(with_secret, 0);
+  builder.output(with_public, 1);
+  executor.run();
+
+  Shape expect_shape{1, 3, 3, 2};
+  for (size_t index = 0; index < 2; index++) {
+    auto output = executor.output(index);
+    EXPECT_EQ(output.shape(), expect_shape);
+    for (size_t i = 0; i < 3; i++) {
+      for (size_t j = 0; j < 3; j++) {
+        for (size_t f = 0; f < 2; f++) {
+          float expected = 0;
+          for (size_t di = 0; di < 2; di++) {
+            for (size_t dj = 0; dj < 2; dj++) {
+              if (i + di < 3 && j + dj < 3) {
+                expected += x_values[(i + di) * 3 + j + dj] *
+                            kernel_values[(di * 2 + dj) * 2 + f];
+              }
+            }
+          }
+          auto raw = output.data()[(i * 3 + j) * 2 + f];
+          EXPECT_NEAR(static_cast<float>(static_cast<int64_t>(raw)) / (1 << 16),
+                      expected, 1e-3);
+        }
+      }
+    }
+  }
+}
+
+TEST(abp_function_test, pooling) {
+  SETUP(16, 1, 3);
+  const float values[] = {1,  -2, 3,    0.5f, 4,  -1, 2,  0,
+                          -3, 5,  1.5f, -4,   -6, 2,  -1, 0.25f};
+  auto tensor = eager::Tensor::with_shape({1, 4, 4, 1});
+  for (size_t i = 0; i < 16; i++) {
+    tensor.data()[i] =
+        static_cast<uint64_t>(static_cast<int64_t>(values[i] * (1 << 16)));
+  }
+  executor.input(0) = tensor;
+  auto x = builder.input(0, Type{
+                                .kind = TypeKind::kArithFixed64,
+                                .fixed_point = 16,
+                                .shape = builder.push(Shape{1, 4, 4, 1}),
+                            });
+  const Shape window{1, 2, 2, 1};
+  const ConvWindow halve{.strides = {1, 2, 2, 1}};
+  // 3x3 windows around every element, all of them padded but one
+  const ConvWindow same{.padding = {{0, 0}, {1, 1}, {1, 1}, {0, 0}}};
+  builder.output(max_pool(builder, x, window, halve), 0);
+  builder.output(avg_pool(builder, x, window, halve), 1);
+  builder.output(max_pool(builder, x, {1, 3, 3, 1}, same), 2);
+  executor.run();
+
+  auto decode = [&](size_t index, size_t i) {
+    auto raw = executor.output(index).data()[i];
+    return static_cast<float>(static_cast<int64_t>(raw)) / (1 << 16);
+  };
+  Shape halved_shape{1, 2, 2, 1};
+  EXPECT_EQ(executor.output(0).shape(), halved_shape);
+  EXPECT_EQ(executor.output(1).shape(), halved_shape);
+  for (size_t i = 0; i < 2; i++) {
+    for (size_t j = 0; j < 2; j++) {
+      float top = values[8 * i + 2 * j], sum = 0;
+      for (size_t di = 0; di < 2; di++) {
+        for (size_t dj = 0; dj < 2; dj++) {
+          top = std::max(top, values[4 * (2 * i + di) + 2 * j + dj]);
+          sum += values[4 * (2 * i + di) + 2 * j + dj];
+        }
+      }
+      EXPECT_EQ(decode(0, 2 * i + j), top);
+      EXPECT_NEAR(decode(1, 2 * i + j), sum / 4, 1e-3);
+    }
+  }
+  Shape same_shape{1, 4, 4, 1};
+  EXPECT_EQ(executor.output(2).shape(), same_shape);
+  for (int i = 0; i < 4; i++) {
+    for (int j = 0; j < 4; j++) {
+      float top = values[4 * i + j];
+      for (int di = -1; di <= 1; di++) {
+        for (int dj = -1; dj <= 1; dj++) {
+          if (i + di >= 0 && i + di < 4 && j + dj >= 0 && j + dj < 4) {
+            top = std::max(top, values[4 * (i + di) + j + dj]);
+          }
+        }
+      }
+      EXPECT_EQ(decode(2, 4 * i + j), top);
+    }
+  }
+}
+
+TEST(abp_function_test, dot_general_batched) {
+  SETUP(15, 2, 2);
+  // two heads of [2, 2] x [2, 1]
+  const float left_values[] = {0.5f, -1.25f, 2.f, 1.5f,
+                               0.25f, -0.75f, 1.f, 3.f};
+  const float right_values[] = {1.f, 0.5f, -0.5f, 2.f};
+  auto left_tensor = eager::Tensor::with_shape({2, 2, 2});
+  auto right_tensor = eager::Tensor::with_shape({2, 2, 1});
+  for (size_t i = 0; i < 8; i++) {
+    left_tensor.data()[i] =
+        static_cast<uint64_t>(static_cast<int64_t>(left_values[i] * (1 << 15)));
+  }
+  for (size_t i = 0; i < 4; i++) {
+    right_tensor.data()[i] = static_cast<uint64_t>(
+        static_cast<int64_t>(right_values[i] * (1 << 15)));
+  }
+  executor.input(0) = left_tensor;
+  executor.input(1) = right_tensor;
+  auto left = builder.input(0, Type{
+                                   .kind = TypeKind::kArithFixed64,
+                                   .fixed_point = 15,
+                                   .shape = builder.push(Shape{2, 2, 2}),
+                               });
+  auto right = builder.input(1, Type{
+                                    .kind = TypeKind::kArithFixed64,
+                                    .fixed_point = 15,
+                                    .shape = builder.push(Shape{2, 2, 1}),
+                                });
+  auto secret = dot_general(builder, left, right);
+  // a public left operand takes the transposed dot_general_ap
+  auto public_left = builder.input(0, Type{
+                                          .kind = TypeKind::kFixed64,
+                                          .fixed_point = 15,
+                                          .shape = builder.push(Shape{2, 2, 2}),
+                                      });
+  auto mixed = dot_general(builder, public_left, right);
+  // every head in the same product round
+  EXPECT_EQ(estimate_cost(context, secret).rounds, 1u);
+  builder.output(secret, 0);
+  builder.output(mixed, 1);
+  executor.run();
+
+  Shape expect_shape{2, 2, 1};
+  const float expected[] = {0.5f - 0.625f, 2.f + 0.75f, -0.125f - 1.5f,
+                            -0.5f + 6.f};
+  for (size_t index = 0; index < 2; index++) {
+    auto output = executor.output(index);
+    EXPECT_EQ(output.shape(), expect_shape);
+    for (size_t i = 0; i < 4; i++) {
+      auto raw = static_cast<int64_t>(output.data()[i]);
+      EXPECT_NEAR(static_cast<float>(raw) / (1 << 15), expected[i], 1e-4);
+    }
+  }
+}
+
+TEST(abp_function_test, dot_general_transposed) {
+  SETUP(15, 2, 2);
+  // x is [3, 2] and read as [2, 3]
+  const float left_values[] = {0.5f, -1.f, 2.f, 0.25f, -0.5f, 1.5f};
+  const float right_values[] = {1.f, 0.5f, -2.f};
+  auto left_tensor = eager::Tensor::with_shape({3, 2});
+  auto right_tensor = eager::Tensor::with_shape({3, 1});
+  for (size_t i = 0; i < 6; i++) {
+    left_tensor.data()[i] =
+        static_cast<uint64_t>(static_cast<int64_t>(left_values[i] * (1 << 15)));
+  }
+  for (size_t i = 0; i < 3; i++) {
+    right_tensor.data()[i] = static_cast<uint64_t>(
+        static_cast<int64_t>(right_values[i] * (1 << 15)));
+  }
+  executor.input(0) = left_tensor;
+  executor.input(1) = right_tensor;
+  auto left = builder.input(0, Type{
+                                   .kind = TypeKind::kArithFixed64,
+                                   .fixed_point = 15,
+                                   .shape = builder.push(Shape{3, 2}),
+                               });
+  auto right = builder.input(1, Type{
+                                    .kind = TypeKind::kArithFixed64,
+                                    .fixed_point = 15,
+                                    .shape = builder.push(Shape{3, 1}),
+                                });
+  auto secret = dot_general(builder, left, right, true, false);
+  // the flag replaces the transpose of the shares
+  for (size_t i = 0; i < context.ops_size(); i++) {
+    context.visit(OpHandle(i), [](OpHandle, auto &&op) {
+      using T = std::decay_t<decltype(op)>;
+      EXPECT_FALSE((std::is_same_v<T, TransposeOp>));
+    });
+  }
+  // an explicit transpose of the last two dimensions folds into the flag
+  auto transposed = builder.transpose(left, {1, 0});
+  auto folded = builder.dot_general_aa(transposed, right);
+  context.visit(folded, [&](OpHandle, auto &&op) {
+    using T = std::decay_t<decltype(op)>;
+    if constexpr (std::is_same_v<T, DotGeneralAAOp>) {
+      EXPECT_EQ(op.left, left);
+      EXPECT_TRUE(op.transpose_left);
+      EXPECT_FALSE(op.transpose_right);
+    } else {
+      ADD_FAILURE();
+    }
+  });
+  auto public_left = builder.input(0, Type{
+                                          .kind = TypeKind::kFixed64,
+                                          .fixed_point = 15,
+                                          .shape = builder.push(Shape{3, 2}),
+                                      });
+  auto mixed = dot_general(builder, public_left, right, true, false);
+  // the public left operand is read in place as well, the explicit transpose
+  // above is the only one
+  size_t transposes = 0;
+  for (size_t i = 0; i < context.ops_size(); i++) {
+    context.visit(OpHandle(i), [&](OpHandle, auto &&op) {
+      using T = std::decay_t<decltype(op)>;
+      transposes += std::is_same_v<T, TransposeOp>;
+    });
+  }
+  EXPECT_EQ(transposes, 1u);
+  builder.output(secret, 0);
+  builder.output(mixed, 1);
+  executor.run();
+
+  Shape expect_shape{2, 1};
+  const float expected[] = {0.5f + 1.f + 1.f, -1.f + 0.125f - 3.f};
+  for (size_t index = 0; index < 2; index++) {
+    auto output = executor.output(index);
+    EXPECT_EQ(output.shape(), expect_shape);
+    for (size_t i = 0; i < 2; i++) {
+      auto raw = static_cast<int64_t>(output.data()[i]);
+      EXPECT_NEAR(static_cast<float>(raw) / (1 << 15), expected[i], 1e-4);
+    }
+  }
+}
+
+TEST(abp_function_test, gather) {
+  SETUP(16, 2, 1);
+  // a secret table [4, 2] and public row indices [3]
+  const float table_values[] = {1, -1, 0.5f, 2, -3, 0.25f, 4, -0.5f};
+  const uint64_t index_values[] = {2, 0, 7};
+  auto table_tensor = eager::Tensor::with_shape({4, 2});
+  for (size_t i = 0; i < 8; i++) {
+    table_tensor.data()[i] = static_cast<uint64_t>(
+        static_cast<int64_t>(table_values[i] * (1 << 16)));
+  }
+  auto index_tensor = eager::Tensor::with_shape({3});
+  std::copy_n(index_values, 3, index_tensor.data());
+  executor.input(0) = table_tensor;
+  executor.input(1) = index_tensor;
+  auto table = builder.input(0, Type{
+                                    .kind = TypeKind::kArithFixed64,
+                                    .fixed_point = 16,
+                                    .shape = builder.push(Shape{4, 2}),
+                                });
+  auto indices = builder.input(1, Type{
+                                      .kind = TypeKind::kFixed64,
+                                      .fixed_point = 0,
+                                      .shape = builder.push(Shape{3}),
+                                  });
+  auto result = builder.gather(table, indices);
+  // every share copies its rows locally
+  EXPECT_EQ(estimate_cost(context, result).rounds, 0u);
+  builder.output(result, 0);
+  executor.run();
+
+  // index 7 is clamped to the last row
+  Shape expect_shape{3, 1, 2};
+  const float expected[] = {-3, 0.25f, 1, -1, 4, -0.5f};
+  auto output = executor.output(0);
+  EXPECT_EQ(output.shape(), expect_shape);
+  for (size_t i = 0; i < 6; i++) {
+    auto raw = static_cast<int64_t>(output.data()[i]);
+    EXPECT_EQ(static_cast<float>(raw) / (1 << 16), expected[i]);
+  }
+}
+
+TEST(abp_function_test, quantized_exp) {
+  SETUP(18, 1, 1);
+  // 8-bit inputs on [-8, 0) in steps of 1/32
+  const float x_values[] = {-8.f, -2.5f, -0.03125f, -5.21875f};
+  auto x_tensor = eager::Tensor::with_shape({4});
+  for (size_t i = 0; i < 4; i++) {
+    x_tensor.data()[i] =
+        static_cast<uint64_t>(static_cast<int64_t>(x_values[i] * (1 << 18)));
+  }
+  executor.input(0) = x_tensor;
+  auto x = builder.input(0, Type{
+                                .kind = TypeKind::kArithFixed64,
+                                .fixed_point = 18,
+                                .shape = builder.push(Shape{4}),
+                            });
+  builder.assume(x, Range{-8, -0.03125});
+  auto f = [](float value) { return std::exp(value); };
+  auto result = quantized(builder, x, f, -8.f, 0.03125f, 256);
+  auto cost = estimate_cost(context, result);
+  auto exp_cost = estimate_cost(context, exp(builder, x));
+  RecordProperty("rounds", static_cast<int>(cost.rounds));
+  RecordProperty("exp_rounds", static_cast<int>(exp_cost.rounds));
+  EXPECT_LT(cost.rounds, exp_cost.rounds);
+  builder.output(result, 0);
+  executor.run();
+
+  auto output = executor.output(0);
+  for (size_t i = 0; i < 4; i++) {
+    auto raw = static_cast<int64_t>(output.data()[i]);
+    EXPECT_NEAR(static_cast<float>(raw) / (1 << 18), std::exp(x_values[i]),
+                1e-5);
+  }
 }
\ No newline at end of file
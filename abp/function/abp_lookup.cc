@@ -0,0 +1,104 @@
+#include "fastmpc/abp/function/abp_lookup.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include <numeric>
+#include <utility>
+
+#include "fastmpc/abp/function/abp_binary.h"
+#include "fastmpc/abp/function/abp_compare.h"
+#include "fastmpc/abp/function/abp_constant.h"
+
+namespace fastmpc::abp {
+
+namespace {
+
+// public row of raw keys at `fixed_point`, broadcast along the last dimension
+// of `shape`
+auto key_row(ABPBuilder &builder, const std::vector<int64_t> &keys,
+             uint8_t fixed_point, const Shape &shape) -> OpHandle {
+  DenseValue dense_value(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    dense_value[i] = static_cast<uint64_t>(keys[i]);
+  }
+  Type type{
+      .kind = TypeKind::kFixed64,
+      .fixed_point = fixed_point,
+      .shape = builder.push(Shape{keys.size()}),
+  };
+  auto result = builder.constant(builder.push(std::move(dense_value)), type);
+  return builder.broadcast(result, {shape.size() - 1},
+                           builder.push(Shape(shape)));
+}
+
+} // namespace
+
+auto lookup(ABPBuilder &builder, OpHandle x, const std::vector<float> &keys,
+            const std::vector<float> &values) -> OpHandle {
+  auto &context = builder.context();
+  auto type = context.type(x);
+  auto shape = context.shape(x);
+  assert(type.kind == TypeKind::kArithFixed64);
+  assert(keys.size() == values.size());
+
+  // only the keys x can hold
+  auto range = context.range(x);
+  std::vector<int64_t> raw_keys;
+  std::vector<float> table;
+  for (size_t i = 0; i < keys.size(); i++) {
+    if (keys[i] >= range.lower && keys[i] <= range.upper) {
+      raw_keys.push_back(std::llround(std::ldexp(keys[i], type.fixed_point)));
+      table.push_back(values[i]);
+    }
+  }
+  if (raw_keys.empty()) {
+    return constant_like(builder, x, 0.f);
+  }
+
+  // [x..., keys] of 0 and 1, a single one where x holds a key
+  size_t rank = shape.size();
+  size_t count = raw_keys.size();
+  Shape wide = shape;
+  wide.push_back(count);
+  DenseSizeT dimensions(rank);
+  std::iota(dimensions.begin(), dimensions.end(), size_t{0});
+  auto candidates =
+      builder.broadcast(x, std::move(dimensions), builder.push(Shape(wide)));
+  auto one_hot = isEqual(builder, candidates,
+                         key_row(builder, raw_keys, type.fixed_point, wide));
+
+  // the bits are at fixed point 0, the product needs no truncation
+  size_t rows = std::accumulate(shape.begin(), shape.end(), size_t{1},
+                                std::multiplies<>());
+  one_hot = builder.reshape(one_hot, builder.push(Shape{rows, count}));
+  auto [lowest, highest] = std::minmax_element(table.begin(), table.end());
+  Range result_range{std::min(*lowest, 0.f), std::max(*highest, 0.f)};
+  auto column = constant(builder, std::move(table), Shape{count, 1});
+  auto result = dot_general(builder, one_hot, column);
+  result = builder.reshape(result, builder.push(std::move(shape)));
+  builder.assume(result, result_range);
+  return result;
+}
+
+auto lookup(ABPBuilder &builder, OpHandle x, const std::vector<float> &table)
+    -> OpHandle {
+  std::vector<float> keys(table.size());
+  std::iota(keys.begin(), keys.end(), 0.f);
+  return lookup(builder, x, keys, table);
+}
+
+auto quantized(ABPBuilder &builder, OpHandle x,
+               const std::function<float(float)> &f, float lower, float step,
+               size_t count) -> OpHandle {
+  std::vector<float> keys(count);
+  std::vector<float> values(count);
+  for (size_t i = 0; i < count; i++) {
+    keys[i] = lower + static_cast<float>(i) * step;
+    values[i] = f(keys[i]);
+  }
+  return lookup(builder, x, keys, values);
+}
+
+} // namespace fastmpc::abp
\ No newline at end of file
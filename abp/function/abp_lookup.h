@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "fastmpc/abp/dialect/abp_builder.h"
+
+namespace fastmpc::abp {
+
+// values[i] where x equals keys[i], and 0 where x matches no key. x is
+// compared with every key in one batched equality test. The one-hot bits then
+// select from the public values by a local matrix product, so the rounds are
+// those of one comparison whatever the function; a narrow range of x narrows
+// it further. Keys outside the range of x are dropped. x has to hold the keys
+// exactly, at its own fixed point.
+auto lookup(ABPBuilder &builder, OpHandle x, const std::vector<float> &keys,
+            const std::vector<float> &values) -> OpHandle;
+
+// table[x] for secret integers x in [0, table.size()).
+auto lookup(ABPBuilder &builder, OpHandle x, const std::vector<float> &table)
+    -> OpHandle;
+
+// f on quantized inputs x = lower + i * step, i in [0, count), as a lookup in
+// a table of count entries. An 8-bit activation takes 256 entries instead of
+// the polynomial or iterative pipelines of exp, log or gelu.
+auto quantized(ABPBuilder &builder, OpHandle x,
+               const std::function<float(float)> &f, float lower, float step,
+               size_t count) -> OpHandle;
+
+} // namespace fastmpc::abp
\ No newline at end of file
@@ -5,27 +5,39 @@
 #include "fastmpc/abp/function/abp_unary.h"
 #include "fastmpc/abp/function/abp_divide.h"
 #include "fastmpc/abp/function/abp_compare.h"
+#include "fastmpc/abp/function/abp_poly.h"
+#include "fastmpc/abp/function/abp_sqrt.h"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
 #include <limits>
+#include <numeric>
 
 using namespace std;
 
 namespace fastmpc::abp {
 
-    auto softmax(ABPBuilder &builder, OpHandle x) -> OpHandle {
+    auto softmax(ABPBuilder &builder, OpHandle x, ExpMode exp_mode) -> OpHandle {
         auto &context = builder.context();
         auto x_type = context.type(x);
         auto x_shape = context.shape(x_type.shape);
         size_t rank = x_shape.size();
         size_t reduce_dim = rank - 1;
 
-        auto max_init = constant(builder, - numeric_limits<float>::infinity());
         Shape reduced_shape = x_shape;
         reduced_shape[reduce_dim] = 1;
-        auto max_val = reduce(builder, x, max_init, {reduce_dim}, {~reduced_shape}, maximize);
-        
-        auto max_val_bcast = builder.broadcast(max_val, {reduce_dim}, x_type.shape);
+        auto max_val = reduce_max(builder, x, {reduce_dim});
+        DenseSizeT kept_dims(reduce_dim);
+        iota(kept_dims.begin(), kept_dims.end(), 0);
+        auto max_val_bcast = builder.broadcast(max_val, ~kept_dims, x_type.shape);
         auto x_shifted = subtract(builder, x, max_val_bcast);
-        auto exp_x = exp(builder, x_shifted);
+        builder.assume(x_shifted, Range{-numeric_limits<double>::infinity(), 0});
+        auto exp_x = exp(builder, x_shifted, exp_mode);
+        // exp(x - max) <= 1, with room for the approximation error. The sum
+        // of exp_x is then known to be positive and divide skips its sign.
+        builder.assume(exp_x, Range{0, 2});
 
         auto sum_init = constant(builder, 0.0f);
         auto sum_exp = reduce(builder, exp_x, sum_init, {reduce_dim}, {~reduced_shape}, add);
@@ -35,14 +47,197 @@ namespace fastmpc::abp {
         return result;
     }
 
-    auto gelu(ABPBuilder &builder, OpHandle x) -> OpHandle {
+    namespace {
+
+        // (1 + x / 2^8)^(2^8) stays within [0, 1] for x in [-16, 0]
+        constexpr float  kClipThreshold = 16.f;
+        constexpr size_t kClipSquarings = 8;
+
+        // Whether the smallest term of a row, with x - bound down to `lowest`,
+        // stays above what the truncation after every squaring can take away.
+        auto positive_terms(double lowest, uint8_t fixed_point) -> bool {
+            auto ulp   = std::ldexp(1.0, -fixed_point);
+            auto term  = 1 + std::max(lowest, -double{kClipThreshold}) / (1 << kClipSquarings);
+            auto error = ulp;
+            for (size_t i = 0; i < kClipSquarings; i++) {
+                error = 2 * term * error + ulp;
+                term *= term;
+            }
+            return term > error;
+        }
+
+        auto softmax_clip(ABPBuilder &builder, OpHandle x) -> OpHandle {
+            auto &context = builder.context();
+            auto x_type = context.type(x);
+            size_t reduce_dim = context.shape(x_type.shape).size() - 1;
+
+            // shift by a public bound instead of the secret maximum
+            auto x_range = context.range(x);
+            auto bound = x_range.upper;
+            if (!(bound < full_range(x_type).upper)) {
+                // kClip needs x bounded with ABPBuilder::assume
+                std::abort();
+            }
+            auto x_shifted = subtract(builder, x, constant_like(builder, x, static_cast<float>(bound)));
+            auto floor_val = constant_like(builder, x_shifted, -kClipThreshold);
+            auto x_clipped = maximize(builder, x_shifted, floor_val);
+
+            auto one   = constant_like(builder, x_clipped, 1.0f);
+            auto exp_x = add(builder, builder.divide_pow_of_2(x_clipped, kClipSquarings), one);
+            for (size_t i = 0; i < kClipSquarings; i++)
+                exp_x = multiply(builder, exp_x, exp_x);
+            builder.assume(exp_x, Range{0, 2});
+
+            // one reciprocal per row instead of a division per element
+            auto sum_exp    = reduce_sum(builder, exp_x, {reduce_dim});
+            if (!positive_terms(x_range.lower - bound, context.type(exp_x).fixed_point)) {
+                // every term of a row may round to 0
+                auto ulp = std::ldexp(1.f, -context.type(sum_exp).fixed_point);
+                sum_exp  = maximize(builder, sum_exp, constant_like(builder, sum_exp, ulp));
+            }
+            auto reciprocal = divide(builder, constant_like(builder, sum_exp, 1.0f), sum_exp);
+            DenseSizeT kept_dims(reduce_dim);
+            iota(kept_dims.begin(), kept_dims.end(), 0);
+            auto reciprocal_bcast = builder.broadcast(reciprocal, ~kept_dims, x_type.shape);
+            return multiply(builder, exp_x, reciprocal_bcast);
+        }
+
+    }
+
+    auto softmax(ABPBuilder &builder, OpHandle x, SoftmaxMode mode) -> OpHandle {
+        switch (mode) {
+        case SoftmaxMode::kMax:
+            return softmax(builder, x);
+        case SoftmaxMode::kClip:
+            return softmax_clip(builder, x);
+        default:
+            std::abort();
+        }
+    }
+
+    auto gelu(ABPBuilder &builder, OpHandle x, ExpMode exp_mode) -> OpHandle {
         auto c1          = constant(builder, -1.702f);
         auto arg         = multiply(builder, c1, x);
-        auto exp_val     = exp(builder, arg);
+        auto exp_val     = exp(builder, arg, exp_mode);
         auto c2          = constant(builder, 1.0f);
         auto denominator = add(builder, c2, exp_val);
         auto result      = divide(builder, x, denominator);
         return result;
     }
 
+    // least-squares fits of x * Phi(x) on [-4, 4], 0 and x outside
+    auto gelu_piecewise(ABPBuilder &builder, OpHandle x) -> OpHandle {
+        return piecewise_poly(builder, x, {-4.f, -2.f, 0.f, 2.f, 4.f}, {
+            {0.f},
+            {-0.701274708f, -0.701816559f, -0.265050939f, -0.0447146228f, -0.00283993917f},
+            {0.000994431297f, 0.525783118f, 0.505864666f, 0.152366174f, 0.0124886754f},
+            {0.000994431297f, 0.474216882f, 0.505864666f, -0.152366174f, 0.0124886754f},
+            {-0.701274708f, 1.701816559f, -0.265050939f, 0.0447146228f, -0.00283993917f},
+            {0.f, 1.f},
+        });
+    }
+
+    // least-squares fits of 1 / (1 + e^-x) on [-8, 8], 0 and 1 outside
+    auto sigmoid(ABPBuilder &builder, OpHandle x) -> OpHandle {
+        return piecewise_poly(builder, x, {-8.f, -2.5f, 2.5f, 8.f}, {
+            {0.f},
+            {0.566612856f, 0.393165658f, 0.113513265f, 0.0168524671f, 0.00127439112f, 3.89799414e-05f},
+            {0.5f, 0.24790201f, 0.f, -0.0178072293f, 0.f, 0.000851852432f},
+            {0.433387144f, 0.393165658f, -0.113513265f, 0.0168524671f, -0.00127439112f, 3.89799414e-05f},
+            {1.f},
+        });
+    }
+
+    // tanh(x) = 2 * sigmoid(2 * x) - 1
+    auto tanh(ABPBuilder &builder, OpHandle x) -> OpHandle {
+        auto s = sigmoid(builder, add(builder, x, x));
+        return subtract(builder, add(builder, s, s), constant_like(builder, s, 1.0f));
+    }
+
+    auto layer_norm(ABPBuilder &builder, OpHandle x, OpHandle gamma, OpHandle beta, size_t axis,
+                    float epsilon) -> OpHandle {
+        auto &context = builder.context();
+        auto x_type = context.type(x);
+        auto x_shape = context.shape(x_type.shape);
+        size_t rank = x_shape.size();
+        assert(axis < rank);
+        uint8_t fixed_point = builder.fixed_point();
+        uint64_t n = x_shape[axis];
+
+        // stack x and x^2, both at 2 * fixed_point, and sum them in one local
+        // pass with a single truncation
+        Shape stacked_shape(rank + 1);
+        Shape batch_shape(rank - 1);
+        DenseSizeT batch_dims(rank - 1);
+        stacked_shape[0] = 1;
+        for (size_t i = 0, j = 0; i < rank; i++) {
+            stacked_shape[i + 1] = x_shape[i];
+            if (i == axis) continue;
+            batch_shape[j] = x_shape[i];
+            batch_dims[j++] = i;
+        }
+        auto stacked_handle = builder.push(~stacked_shape);
+        auto batch_handle = builder.push(~batch_shape);
+
+        auto one = constant_like(builder, x, 1.0f);
+        auto x_wide = unsafe::multiply(builder, x, one);
+        auto x_square = unsafe::multiply(builder, x, x);
+        auto stacked = builder.concate({builder.reshape(x_wide, stacked_handle),
+                                        builder.reshape(x_square, stacked_handle)}, 0);
+        auto sums = truncate(builder, builder.reduce_sum(stacked, {axis + 1}), fixed_point);
+
+        auto sums_shape = context.shape(sums);
+        auto moment = [&](size_t k) {
+            DenseSizeT start(sums_shape.size());
+            DenseSizeT end(sums_shape.size());
+            for (size_t i = 0; i < sums_shape.size(); i++) {
+                start[i] = 0;
+                end[i] = sums_shape[i];
+            }
+            start[0] = k;
+            end[0] = k + 1;
+            return builder.reshape(builder.slice(sums, ~start, ~end), batch_handle);
+        };
+        auto sum = moment(0);
+        auto sum_square = moment(1);
+
+        // n^2 * (variance + epsilon) = n * sum(x^2) - sum(x)^2 + n^2 * epsilon,
+        // so neither the mean nor the variance is divided by n
+        auto n_sum_square = unsafe::multiply(builder, sum_square, constant_like(builder, sum_square, n));
+        auto scaled_variance = subtract(builder, n_sum_square, multiply(builder, sum, sum));
+        auto scaled_epsilon = constant_like(builder, scaled_variance, epsilon * n * n);
+        scaled_variance = add(builder, scaled_variance, scaled_epsilon);
+
+        // with 2^k >= n, rsqrt of n^2 * (variance + epsilon) / 4^k stays in its
+        // domain and gives 2^k / (n * std) in [1 / std, 2 / std) at the fixed
+        // point, which is 1 / (n * std) at k more fractional bits
+        auto k = static_cast<uint8_t>(bit_width(n - 1));
+        auto inv_std = rsqrt(builder, builder.divide_pow_of_2(scaled_variance, 2 * k));
+        if (k > 0) {
+            // public 2^-k with a raw value of 1, the product only moves the fixed point
+            DenseValue raw_one(1, 1);
+            auto ulp = builder.constant(builder.push(move(raw_one)), Type{
+                .kind = TypeKind::kFixed64,
+                .fixed_point = k,
+                .shape = builder.push(Shape{}),
+            });
+            if (!batch_shape.empty())
+                ulp = builder.broadcast(ulp, {}, batch_handle);
+            inv_std = unsafe::multiply(builder, inv_std, ulp);
+        }
+
+        // (n * x - sum(x)) * inv_std = (x - mean) / sqrt(variance + epsilon),
+        // truncated back to the fixed point after the multiply
+        auto n_x = unsafe::multiply(builder, x, constant_like(builder, x, n));
+        auto centered = subtract(builder, n_x, builder.broadcast(sum, DenseSizeT(batch_dims), x_type.shape));
+        auto normalized = unsafe::multiply(builder, centered, builder.broadcast(inv_std, ~batch_dims, x_type.shape));
+        normalized = truncate(builder, normalized, fixed_point + k);
+
+        // gamma and beta are applied at 2 * fixed_point and share the last truncation
+        auto scaled = unsafe::multiply(builder, normalized, builder.broadcast(gamma, {axis}, x_type.shape));
+        auto wide_beta = builder.broadcast(beta, {axis}, x_type.shape);
+        wide_beta = unsafe::multiply(builder, wide_beta, one);
+        return truncate(builder, add(builder, scaled, wide_beta), fixed_point);
+    }
+
 }
\ No newline at end of file
@@ -1,9 +1,34 @@
 #pragma once
 #include "fastmpc/abp/dialect/abp_builder.h"
+#include "fastmpc/abp/function/abp_unary.h"
 
 namespace fastmpc::abp {
-    
-    auto softmax(ABPBuilder &builder, OpHandle x) -> OpHandle;
-    auto    gelu(ABPBuilder &builder, OpHandle x) -> OpHandle;
+
+    enum class SoftmaxMode {
+        // exp(x - max(x)) over a comparison tree, divided elementwise by the
+        // row sum
+        kMax,
+        // exp(x - bound) with the public upper bound of the range of x, inputs
+        // more than 16 below the bound clipped in one comparison, exp by 8
+        // squarings and one reciprocal of the row sum. Needs x bounded with
+        // ABPBuilder::assume and aborts otherwise, the error is about 4e-3
+        // when the row maximum reaches the bound and doubles for every 2 it
+        // stays below it. Row sums are floored at one unit in the last place
+        // when x may lie far enough below the bound for every term to round
+        // to 0.
+        kClip,
+    };
+
+    auto softmax(ABPBuilder &builder, OpHandle x, ExpMode exp_mode = ExpMode::kSquaring) -> OpHandle;
+    auto softmax(ABPBuilder &builder, OpHandle x, SoftmaxMode mode) -> OpHandle;
+    auto    gelu(ABPBuilder &builder, OpHandle x, ExpMode exp_mode = ExpMode::kSquaring) -> OpHandle;
+    // piecewise polynomial fits, absolute error about 1e-3
+    auto gelu_piecewise(ABPBuilder &builder, OpHandle x) -> OpHandle;
+    auto sigmoid(ABPBuilder &builder, OpHandle x) -> OpHandle;
+    auto    tanh(ABPBuilder &builder, OpHandle x) -> OpHandle;
+    // (x - mean) / sqrt(variance + epsilon) * gamma + beta over `axis`,
+    // gamma and beta have the shape {x.shape[axis]}
+    auto layer_norm(ABPBuilder &builder, OpHandle x, OpHandle gamma, OpHandle beta, size_t axis,
+                    float epsilon = 1e-5f) -> OpHandle;
     
 }
\ No newline at end of file
@@ -0,0 +1,183 @@
+#include "fastmpc/abp/function/abp_poly.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+
+#include "fastmpc/abp/function/abp_binary.h"
+#include "fastmpc/abp/function/abp_constant.h"
+#include "fastmpc/abp/function/abp_unary.h"
+
+namespace fastmpc::abp {
+
+namespace {
+
+// x^0 .. x^degree, x^m = x^(2^k) * x^(m - 2^k) is ceil(log2(m)) rounds deep.
+auto powers(ABPBuilder &builder, OpHandle x, size_t degree) {
+  std::vector<OpHandle> result{constant_like(builder, x, 1.f)};
+  for (size_t m = 1; m <= degree; m++) {
+    size_t high = std::bit_floor(m);
+    if (m == 1) {
+      result.push_back(x);
+    } else if (high == m) {
+      result.push_back(multiply(builder, result[m / 2], result[m / 2]));
+    } else {
+      result.push_back(multiply(builder, result[high], result[m - high]));
+    }
+  }
+  return result;
+}
+
+auto encode(double value, int exponent) -> int64_t {
+  return std::llround(std::ldexp(value, exponent));
+}
+
+// public {values.size()} table at the fixed point of the builder, broadcast
+// along the leading dimension of `shape`
+auto table(ABPBuilder &builder, std::vector<int64_t> values,
+           ShapeHandle shape) {
+  size_t size = values.size();
+  DenseValue dense_value(size);
+  for (size_t i = 0; i < size; i++) {
+    dense_value[i] = static_cast<uint64_t>(values[i]);
+  }
+  Type type{
+      .kind = TypeKind::kFixed64,
+      .fixed_point = builder.fixed_point(),
+      .shape = builder.push(Shape{size}),
+  };
+  auto result = builder.constant(builder.push(std::move(dense_value)), type);
+  return builder.broadcast(result, {0}, shape);
+}
+
+// public scalar at the fixed point of the builder, broadcast to `shape`
+auto scalar(ABPBuilder &builder, int64_t value, ShapeHandle shape) {
+  Type type{
+      .kind = TypeKind::kFixed64,
+      .fixed_point = builder.fixed_point(),
+      .shape = builder.push(Shape{}),
+  };
+  DenseValue dense_value(1);
+  dense_value[0] = static_cast<uint64_t>(value);
+  auto result = builder.constant(builder.push(std::move(dense_value)), type);
+  if (!builder.context().shape(shape).empty())
+    result = builder.broadcast(result, {}, shape);
+  return result;
+}
+
+// sum_m coefficients[m] * powers[m] at twice the fixed point, multiplying by
+// public coefficients is local
+auto weighted_sum(ABPBuilder &builder, const std::vector<OpHandle> &powers,
+                  const std::vector<int64_t> &coefficients) {
+  auto shape = builder.context().type(powers[0]).shape;
+  auto result = unsafe::multiply(builder, powers[0],
+                                 scalar(builder, coefficients[0], shape));
+  for (size_t m = 1; m < coefficients.size(); m++) {
+    auto c = scalar(builder, coefficients[m], shape);
+    result = add(builder, result, unsafe::multiply(builder, powers[m], c));
+  }
+  return result;
+}
+
+} // namespace
+
+auto polynomial(ABPBuilder &builder, OpHandle x,
+                const std::vector<float> &coefficients) -> OpHandle {
+  assert(!coefficients.empty());
+  uint8_t fixed_point = builder.fixed_point();
+  std::vector<int64_t> encoded(coefficients.size());
+  for (size_t m = 0; m < coefficients.size(); m++) {
+    encoded[m] = encode(coefficients[m], fixed_point);
+  }
+  auto x_powers = powers(builder, x, coefficients.size() - 1);
+  return truncate(builder, weighted_sum(builder, x_powers, encoded),
+                  fixed_point);
+}
+
+auto piecewise_poly(ABPBuilder &builder, OpHandle x,
+                    const std::vector<float> &breakpoints,
+                    const std::vector<std::vector<float>> &coefficients)
+    -> OpHandle {
+  auto &context = builder.context();
+  assert(context.type(x).kind == TypeKind::kArithFixed64);
+  assert(coefficients.size() == breakpoints.size() + 1);
+  assert(std::is_sorted(breakpoints.begin(), breakpoints.end()));
+
+  uint8_t fixed_point = builder.fixed_point();
+  size_t degree = 0;
+  for (auto &segment : coefficients) {
+    assert(!segment.empty());
+    degree = std::max(degree, segment.size() - 1);
+  }
+  // The polynomials are evaluated in t = x / 2^scale with |t| <= 1 on the
+  // bounded segments, otherwise tiny coefficients of high powers would be
+  // rounded away at the fixed point.
+  int scale = 0;
+  for (float breakpoint : breakpoints) {
+    while (std::ldexp(1.f, scale) < std::abs(breakpoint))
+      scale++;
+  }
+  // coefficients are encoded before they are subtracted, so the sum over the
+  // segments telescopes exactly in the ring
+  auto coefficient = [&](size_t i, size_t m) -> int64_t {
+    if (m >= coefficients[i].size())
+      return 0;
+    return encode(coefficients[i][m], static_cast<int>(fixed_point + scale * m));
+  };
+  auto t = builder.divide_pow_of_2(x, scale);
+  auto t_powers = powers(builder, t, degree);
+
+  // the last segment, at 2 * fixed_point
+  size_t last = breakpoints.size();
+  std::vector<int64_t> last_coefficients(degree + 1);
+  for (size_t m = 0; m <= degree; m++) {
+    last_coefficients[m] = coefficient(last, m);
+  }
+  auto result = weighted_sum(builder, t_powers, last_coefficients);
+
+  if (!breakpoints.empty()) {
+    // every breakpoint in its own slice of the leading dimension
+    size_t count = breakpoints.size();
+    auto shape = context.shape(x);
+    Shape stacked_shape(shape.size() + 1);
+    DenseSizeT dimensions(shape.size());
+    stacked_shape[0] = count;
+    for (size_t i = 0; i < shape.size(); i++) {
+      stacked_shape[i + 1] = shape[i];
+      dimensions[i] = i + 1;
+    }
+    auto stacked = builder.push(std::move(stacked_shape));
+    auto stack = [&](OpHandle operand) {
+      return builder.broadcast(operand, DenseSizeT(dimensions), stacked);
+    };
+
+    // [x < breakpoints[i]] for every i
+    std::vector<int64_t> bounds(count);
+    for (size_t i = 0; i < count; i++) {
+      bounds[i] = encode(breakpoints[i], fixed_point);
+    }
+    auto diff = subtract(builder, stack(x), table(builder, bounds, stacked));
+    auto below = builder.b2a(builder.shift_right(builder.a2b(diff), 63), 0);
+
+    // sum_j [breakpoints[j - 1] <= x < breakpoints[j]] * p_j(x)
+    //   = p_last(x) + sum_i [x < breakpoints[i]] * (p_i(x) - p_i+1(x))
+    auto delta_term = [&](size_t m) {
+      std::vector<int64_t> differences(count);
+      for (size_t i = 0; i < count; i++) {
+        differences[i] = coefficient(i, m) - coefficient(i + 1, m);
+      }
+      auto c = table(builder, std::move(differences), stacked);
+      return unsafe::multiply(builder, stack(t_powers[m]), c);
+    };
+    auto delta = delta_term(0);
+    for (size_t m = 1; m <= degree; m++) {
+      delta = add(builder, delta, delta_term(m));
+    }
+    auto selected = unsafe::multiply(builder, below, delta);
+    result = add(builder, result, builder.reduce_sum(selected, {0}));
+  }
+  return truncate(builder, result, fixed_point);
+}
+
+} // namespace fastmpc::abp
\ No newline at end of file
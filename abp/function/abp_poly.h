@@ -0,0 +1,24 @@
+#pragma once
+
+#include <vector>
+
+#include "fastmpc/abp/dialect/abp_builder.h"
+
+namespace fastmpc::abp {
+
+// sum_m coefficients[m] * x^m. The powers of x are ceil(log2(degree)) rounds
+// deep and the terms are summed at twice the fixed point with a single
+// truncation.
+auto polynomial(ABPBuilder &builder, OpHandle x,
+                const std::vector<float> &coefficients) -> OpHandle;
+
+// Evaluates coefficients[i] (lowest degree first) on the segment
+// breakpoints[i - 1] <= x < breakpoints[i], where breakpoints are ascending and
+// the first and last segments are unbounded. All breakpoints are compared in
+// one a2b and the segments share the powers of x.
+auto piecewise_poly(ABPBuilder &builder, OpHandle x,
+                    const std::vector<float> &breakpoints,
+                    const std::vector<std::vector<float>> &coefficients)
+    -> OpHandle;
+
+} // namespace fastmpc::abp
\ No newline at end of file
@@ -1,10 +1,15 @@
 #include "fastmpc/abp/function/abp_reduce.h"
 #include "fastmpc/abp/dialect/abp_builder.h"
 #include "fastmpc/abp/dialect/abp_ops.h"
+#include "fastmpc/abp/analysis/abp_cost.h"
+#include "fastmpc/abp/function/abp_binary.h"
+#include "fastmpc/abp/function/abp_compare.h"
 
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <cstdlib>
+#include <functional>
 #include <numeric>
 #include <utility>
 #include <vector>
@@ -59,14 +64,106 @@ auto tree_reduce(ABPBuilder &builder, OpHandle x, ReduceFunc reducer) {
   return tree_reduce_power_of_two(builder, result, reducer);
 }
 
-} // namespace
+auto and_b(ABPBuilder &builder, OpHandle left, OpHandle right) -> OpHandle {
+  return builder.and_bb(left, right);
+}
 
-auto reduce(ABPBuilder &builder, OpHandle x, OpHandle init, DenseSizeT &&dims,
-            Shape &&shape, ReduceFunc reducer) -> OpHandle {
+// Row maxima of a 2d-tensor from all n(n - 1) / 2 comparisons in one a2b.
+// x_i wins when it is above every x_j with j < i and not below every x_j with
+// j > i, so the first of equal maxima is the only winner. The n - 1 conditions
+// of a winner are and-ed in ceil(log2(n - 1)) rounds.
+auto all_pairs_max(ABPBuilder &builder, OpHandle x) -> OpHandle {
+  auto &context = builder.context();
+  auto x_shape = context.shape(x);
+  assert(x_shape.size() == 2);
+  size_t batch_size = x_shape[0];
+  size_t n = x_shape[1];
+  if (n == 1) {
+    return x;
+  }
+
+  // pairs (i, j) with i < j, ordered by i then j
+  std::vector<OpHandle> lefts;
+  std::vector<OpHandle> rights;
+  std::vector<size_t> offsets;
+  size_t pairs = 0;
+  for (size_t i = 0; i + 1 < n; i++) {
+    auto x_i = builder.slice(x, {0, i}, {batch_size, i + 1});
+    auto shape = builder.push(Shape{batch_size, n - 1 - i});
+    lefts.push_back(builder.broadcast(x_i, {0, 1}, shape));
+    rights.push_back(builder.slice(x, {0, i + 1}, {batch_size, n}));
+    offsets.push_back(pairs);
+    pairs += n - 1 - i;
+  }
+  auto left = builder.concate(std::move(lefts), 1);
+  auto right = builder.concate(std::move(rights), 1);
+  auto diff_b = builder.a2b(subtract(builder, left, right));
+  // bit 0 of less is [x_i < x_j], of not_less [x_i >= x_j]
+  auto less = builder.shift_right(diff_b, 63);
+  auto not_less = builder.shift_right(builder.not_b(diff_b), 63);
+
+  std::vector<OpHandle> conditions;
+  for (size_t i = 0; i < n; i++) {
+    for (size_t j = 0; j < i; j++) {
+      size_t pair = offsets[j] + i - j - 1;
+      conditions.push_back(
+          builder.slice(less, {0, pair}, {batch_size, pair + 1}));
+    }
+    if (i + 1 < n) {
+      conditions.push_back(builder.slice(
+          not_less, {0, offsets[i]}, {batch_size, offsets[i] + n - 1 - i}));
+    }
+  }
+  auto table = builder.concate(std::move(conditions), 1);
+  table = builder.reshape(table, builder.push(Shape{batch_size * n, n - 1}));
+  auto wins = tree_reduce(builder, table, and_b);
+  wins = builder.reshape(wins, builder.push(Shape{batch_size, n}));
+  auto selected = multiply(builder, builder.b2a(wins, 0), x);
+  auto result = builder.reduce_sum(selected, {1});
+  return builder.reshape(result, builder.push(Shape{batch_size, 1}));
+}
+
+// all_pairs_max builds n^2 ops, wider rows always use the tournament
+constexpr size_t kAllPairsMaxWidth = 32;
+
+auto row_max(ABPBuilder &builder, OpHandle x, MaxStrategy strategy)
+    -> OpHandle {
+  auto result = [&]() -> OpHandle {
+    switch (strategy) {
+    case MaxStrategy::kTournament:
+      return tree_reduce(builder, x, maximize);
+    case MaxStrategy::kAllPairs:
+      return all_pairs_max(builder, x);
+    }
+    std::abort();
+  }();
+  // the maximum is one of the values
+  builder.assume(result, builder.context().range(x));
+  return result;
+}
+
+// Reduces the rows of x, with the reduced dimensions moved last and
+// flattened, by `reduce_row`.
+auto reduce_rows(ABPBuilder &builder, OpHandle x, OpHandle init,
+                 DenseSizeT &&dims, Shape &&shape, ReduceFunc reducer,
+                 const std::function<OpHandle(OpHandle)> &reduce_row)
+    -> OpHandle {
   auto &context = builder.context();
   auto x_type = context.type(x);
   auto x_shape = context.shape(x_type.shape);
 
+  // Sums are local on arithmetic shares, no need to build a reduction tree.
+  if (reducer == static_cast<ReduceFunc>(add) &&
+      x_type.kind != TypeKind::kBitArray64) {
+    x = builder.reduce_sum(x, std::move(dims));
+    init = builder.broadcast(init, {}, context.type(x).shape);
+    x = add(builder, x, init);
+    if (context.shape(x) != shape) {
+      x = builder.reshape(x, builder.push(std::move(shape)));
+    }
+    return x;
+  }
+
   auto is_reduced_dim = [&dims](size_t i) -> bool {
     return std::find(dims.begin(), dims.end(), i) != dims.end();
   };
@@ -111,7 +208,7 @@ auto reduce(ABPBuilder &builder, OpHandle x, OpHandle init, DenseSizeT &&dims,
     auto handle = builder.push(std::move(std_reduce_shape));
     x = builder.reshape(x, handle);
   }
-  x = tree_reduce(builder, x, reducer);
+  x = reduce_row(x);
   init = builder.broadcast(init, {}, builder.push(Shape{batched_size, 1}));
   x = reducer(builder, x, init);
   if (need_reshape) {
@@ -132,4 +229,81 @@ auto reduce(ABPBuilder &builder, OpHandle x, OpHandle init, DenseSizeT &&dims,
   return x;
 }
 
+} // namespace
+
+auto max_strategy(ABPBuilder &builder, OpHandle x,
+                  const NetworkModel &network) -> MaxStrategy {
+  auto &context = builder.context();
+  auto shape = context.shape(x);
+  size_t n = shape.back();
+  if (n < 3 || n > kAllPairsMaxWidth) {
+    return MaxStrategy::kTournament;
+  }
+  size_t batch_size = std::accumulate(shape.begin(), shape.end() - 1,
+                                      size_t{1}, std::multiplies<>());
+  // both candidates are built on a copy of the rows of x, the context only
+  // gets the chosen one
+  ABPContext scratch;
+  ABPBuilder scratch_builder(scratch, builder.fixed_point());
+  auto type = context.type(x);
+  type.shape = scratch_builder.push(Shape{batch_size, n});
+  auto rows = scratch_builder.input(0, type);
+  scratch_builder.assume(rows, context.range(x));
+  auto tournament = estimate_cost(
+      scratch, row_max(scratch_builder, rows, MaxStrategy::kTournament));
+  auto all_pairs = estimate_cost(
+      scratch, row_max(scratch_builder, rows, MaxStrategy::kAllPairs));
+  return estimate_time(all_pairs, network) < estimate_time(tournament, network)
+             ? MaxStrategy::kAllPairs
+             : MaxStrategy::kTournament;
+}
+
+auto reduce(ABPBuilder &builder, OpHandle x, OpHandle init, DenseSizeT &&dims,
+            Shape &&shape, ReduceFunc reducer) -> OpHandle {
+  return reduce_rows(builder, x, init, std::move(dims), std::move(shape),
+                     reducer, [&](OpHandle rows) {
+                       if (reducer == static_cast<ReduceFunc>(maximize)) {
+                         auto strategy = max_strategy(builder, rows);
+                         return row_max(builder, rows, strategy);
+                       }
+                       return tree_reduce(builder, rows, reducer);
+                     });
+}
+
+auto reduce_max(ABPBuilder &builder, OpHandle operand,
+                const std::vector<size_t> &axis,
+                const NetworkModel &network) -> OpHandle {
+  auto &context = builder.context();
+  auto type = context.type(operand);
+  Shape shape;
+  for (size_t i = 0; i < context.shape(operand).size(); i++) {
+    if (std::find(axis.begin(), axis.end(), i) == axis.end()) {
+      shape.push_back(context.shape(operand)[i]);
+    }
+  }
+  // the lowest value of the ring, the range analysis drops its comparison
+  DenseValue lowest(1);
+  lowest[0] = uint64_t{1} << 63;
+  auto init = builder.constant(builder.push(std::move(lowest)),
+                               Type{
+                                   .kind = TypeKind::kFixed64,
+                                   .fixed_point = type.fixed_point,
+                                   .shape = builder.push(Shape{}),
+                               });
+  DenseSizeT dimensions(axis.size());
+  std::copy(axis.begin(), axis.end(), dimensions.begin());
+  return reduce_rows(builder, operand, init, std::move(dimensions),
+                     std::move(shape), maximize, [&](OpHandle rows) {
+                       auto strategy = max_strategy(builder, rows, network);
+                       return row_max(builder, rows, strategy);
+                     });
+}
+
+auto reduce_sum(ABPBuilder &builder, OpHandle operand,
+                const std::vector<size_t> &axis) -> OpHandle {
+  DenseSizeT dimensions(axis.size());
+  std::copy(axis.begin(), axis.end(), dimensions.begin());
+  return builder.reduce_sum(operand, std::move(dimensions));
+}
+
 } // namespace fastmpc::abp
\ No newline at end of file
@@ -1,4 +1,5 @@
 #pragma once
+#include "fastmpc/abp/analysis/abp_cost.h"
 #include "fastmpc/abp/dialect/abp_builder.h"
 
 using namespace std;
@@ -8,6 +9,18 @@ namespace fastmpc::abp {
     using ReduceFunc = auto (*)(ABPBuilder &, OpHandle, OpHandle) -> OpHandle;
     auto reduce(ABPBuilder &builder, OpHandle x, OpHandle init, DenseSizeT &&dims, Shape &&shape, ReduceFunc reducer) -> OpHandle;
     auto reduce_sum(ABPBuilder &builder, OpHandle operand, const vector <size_t> &axis) -> OpHandle;
-    auto reduce_max(ABPBuilder &builder, OpHandle operand, const vector <size_t> &axis) -> OpHandle;
+
+    // How a row of n values is reduced to its maximum: log2(n) levels of
+    // pairwise comparisons, or all n(n - 1) / 2 comparisons in one round
+    // and-ed together, which sends more but takes far fewer rounds.
+    enum class MaxStrategy {
+        kTournament,
+        kAllPairs,
+    };
+
+    // The faster strategy on `network` for the rows of the last dimension of x.
+    auto max_strategy(ABPBuilder &builder, OpHandle x, const NetworkModel &network = {}) -> MaxStrategy;
+    auto reduce_max(ABPBuilder &builder, OpHandle operand, const vector <size_t> &axis,
+                    const NetworkModel &network = {}) -> OpHandle;
 
 }
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include "fastmpc/abp/function/abp_sqrt.h"
+
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "fastmpc/abp/function/abp_binary.h"
+#include "fastmpc/abp/function/abp_circuit.h"
+#include "fastmpc/abp/function/abp_constant.h"
+#include "fastmpc/abp/function/abp_unary.h"
+
+namespace fastmpc::abp {
+
+namespace {
+
+// 1 / sqrt(m) ~= 1.995 - 1.052 * m on [0.5, 1), relative error below 2^-4.1.
+constexpr float kGuessOffset = 1.995f;
+constexpr float kGuessSlope = 1.052f;
+
+// Every iteration roughly doubles the number of correct bits.
+auto rsqrt_iterations(uint8_t precision) -> size_t {
+  size_t iterations = 0;
+  for (double bits = 4.1; bits < precision; bits = 2 * bits - 0.6) {
+    iterations++;
+  }
+  return iterations;
+}
+
+// Goldschmidt iterations for m in [0.5, 1): g converges to sqrt(m) and h to
+// 1 / (2 * sqrt(m)). The updates of g and h are independent, so an iteration
+// costs two rounds where Newton's y * (3 - m * y^2) / 2 costs three.
+auto rsqrt_normalized(ABPBuilder &builder, OpHandle m, uint8_t precision) {
+  auto guess = [&](float scale) {
+    auto offset = constant_like(builder, m, kGuessOffset * scale);
+    auto slope = constant_like(builder, m, kGuessSlope * scale);
+    return subtract(builder, offset, multiply(builder, m, slope));
+  };
+  auto g = multiply(builder, m, guess(1.f));
+  auto h = guess(0.5f);
+
+  auto half = constant_like(builder, m, 0.5f);
+  size_t iterations = rsqrt_iterations(precision);
+  for (size_t i = 0; i < iterations; i++) {
+    auto r = subtract(builder, half, multiply(builder, g, h));
+    if (i + 1 != iterations)
+      g = add(builder, g, multiply(builder, g, r));
+    h = add(builder, h, multiply(builder, h, r));
+  }
+  return add(builder, h, h);
+}
+
+} // namespace
+
+auto rsqrt(ABPBuilder &builder, OpHandle x) -> OpHandle {
+  uint8_t fixed_point = builder.fixed_point();
+  auto normalized = normalize(builder, x);
+  auto m = multiply(builder, x, normalized.factor);
+  auto y = rsqrt_normalized(builder, m, fixed_point);
+
+  // x = m * 2^(c - fixed_point) where c = 2 * h + b is the popcount of the
+  // mask, so 1 / sqrt(x) = y * s * 2^(31 - h) / 2^(31 - fixed_point / 2) and
+  // s in {1 / sqrt(2), 1, sqrt(2)} absorbs the parities of c and fixed_point.
+  // The integer factors of 2^(31 - h) only depend on the bits of c and are
+  // ready before y.
+  auto bits = thermometer_count_bits(builder, normalized.mask);
+  std::vector<OpHandle> factors;
+  for (size_t i = 0; i < 5; i++) {
+    // bit i of 31 - h is the complement of bit i + 1 of c:
+    // 2^(2^i * (1 - c_i+1)) = 2^(2^i) - (2^(2^i) - 1) * c_i+1
+    uint64_t power = uint64_t{1} << (1u << i);
+    auto bit = b2a(builder, bits[i + 1], 0);
+    auto step = multiply(builder, bit, constant_like(builder, x, power - 1));
+    factors.push_back(subtract(builder, constant_like(builder, x, power), step));
+  }
+
+  float s_even = std::pow(2.f, (fixed_point % 2) / 2.f);
+  float s_odd = std::pow(2.f, (fixed_point % 2 - 1) / 2.f);
+  auto parity = b2a(builder, bits[0], 0);
+  auto s = multiply(builder, parity, constant_like(builder, x, s_odd - s_even));
+  s = add(builder, s, constant_like(builder, x, s_even));
+
+  // y * s is near 1 and keeps its precision at the fixed point. The exact
+  // power of two is applied before the one truncation by 2^(31 - fixed_point /
+  // 2), so a small 1 / sqrt(x) is not rounded at a small scale first.
+  auto power = multiply_all(builder, std::move(factors));
+  auto result = unsafe::multiply(builder, multiply(builder, y, s), power);
+  return builder.divide_pow_of_2(result, 31 - fixed_point / 2);
+}
+
+} // namespace fastmpc::abp
\ No newline at end of file
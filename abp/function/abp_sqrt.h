@@ -0,0 +1,10 @@
+#pragma once
+
+#include "fastmpc/abp/dialect/abp_builder.h"
+
+namespace fastmpc::abp {
+
+// 1 / sqrt(x) for x > 0.
+auto rsqrt(ABPBuilder &builder, OpHandle x) -> OpHandle;
+
+} // namespace fastmpc::abp
\ No newline at end of file
@@ -0,0 +1,169 @@
+#include "fastmpc/abp/function/abp_top_k.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "fastmpc/abp/function/abp_binary.h"
+#include "fastmpc/abp/function/abp_compare.h"
+
+namespace fastmpc::abp {
+
+namespace {
+
+// x[..., start:end, ...] along `dimension`
+auto slice_along(ABPBuilder &builder, OpHandle x, size_t dimension,
+                 size_t start, size_t end) -> OpHandle {
+  auto shape = builder.context().shape(x);
+  DenseSizeT begin(shape.size(), 0);
+  DenseSizeT limit(shape.size());
+  std::copy(shape.begin(), shape.end(), limit.begin());
+  begin[dimension] = start;
+  limit[dimension] = end;
+  return builder.slice(x, std::move(begin), std::move(limit));
+}
+
+auto reshape(ABPBuilder &builder, OpHandle x, Shape shape) -> OpHandle {
+  return builder.reshape(x, builder.push(std::move(shape)));
+}
+
+// x with its last dimension reversed
+auto reverse_last(ABPBuilder &builder, OpHandle x) -> OpHandle {
+  auto shape = builder.context().shape(x);
+  size_t last = shape.size() - 1;
+  if (shape[last] == 1) {
+    return x;
+  }
+  std::vector<OpHandle> columns;
+  for (size_t i = shape[last]; i-- > 0;) {
+    columns.push_back(slice_along(builder, x, last, i, i + 1));
+  }
+  return builder.concate(std::move(columns), last);
+}
+
+// Candidates are stacked along dimension 0: the first half holds the values,
+// the second half their indices.
+//
+// Orders a and b elementwise, the larger value first and a on ties. The bit
+// [a < b] of the values selects values and indices in one multiplication.
+auto compare_exchange(ABPBuilder &builder, OpHandle a, OpHandle b)
+    -> std::pair<OpHandle, OpHandle> {
+  size_t rows = builder.context().shape(a)[0] / 2;
+  auto below = isLess(builder, slice_along(builder, a, 0, 0, rows),
+                      slice_along(builder, b, 0, 0, rows));
+  auto which = builder.concate({below, below}, 0);
+  auto high = add(builder, a, multiply(builder, subtract(builder, b, a), which));
+  auto low = subtract(builder, add(builder, a, b), high);
+  return {high, low};
+}
+
+// Sorts the bitonic lists along the last dimension of x in descending order,
+// one compare_exchange per stride.
+auto bitonic_clean(ABPBuilder &builder, OpHandle x) -> OpHandle {
+  auto shape = builder.context().shape(x);
+  assert(shape.size() == 3);
+  size_t size = shape[2];
+  for (size_t stride = size / 2; stride > 0; stride /= 2) {
+    size_t blocks = shape[1] * size / (2 * stride);
+    auto pairs = reshape(builder, x, {shape[0], blocks, 2, stride});
+    auto [high, low] =
+        compare_exchange(builder, slice_along(builder, pairs, 2, 0, 1),
+                         slice_along(builder, pairs, 2, 1, 2));
+    x = reshape(builder, builder.concate({high, low}, 2), shape);
+  }
+  return x;
+}
+
+// public row of raw values at `fixed_point`, broadcast to {rows, size}
+auto row(ABPBuilder &builder, const std::vector<int64_t> &values, size_t rows,
+         uint8_t fixed_point) -> OpHandle {
+  DenseValue dense_value(values.size());
+  for (size_t i = 0; i < values.size(); i++) {
+    dense_value[i] = static_cast<uint64_t>(values[i]);
+  }
+  Type type{
+      .kind = TypeKind::kFixed64,
+      .fixed_point = fixed_point,
+      .shape = builder.push(Shape{values.size()}),
+  };
+  auto result = builder.constant(builder.push(std::move(dense_value)), type);
+  return builder.broadcast(result, {1},
+                           builder.push(Shape{rows, values.size()}));
+}
+
+} // namespace
+
+auto top_k(ABPBuilder &builder, OpHandle x, size_t k) -> TopK {
+  auto &context = builder.context();
+  auto type = context.type(x);
+  auto shape = context.shape(x);
+  assert(type.kind == TypeKind::kArithFixed64 && !shape.empty());
+  size_t n = shape.back();
+  assert(k > 0 && k <= n);
+  size_t rows = std::accumulate(shape.begin(), shape.end() - 1, size_t{1},
+                                std::multiplies<>());
+  size_t capacity = std::bit_ceil(k);
+  size_t width = std::bit_ceil(n);
+
+  // Pads the rows to a power of two with a value below all of x that keeps
+  // the differences within the ring.
+  auto range = context.range(x);
+  auto lowest = std::ldexp(range.lower, type.fixed_point) - 1;
+  auto pad = static_cast<int64_t>(std::max(lowest, -std::ldexp(1.0, 62)));
+  auto values = reshape(builder, x, {rows, n});
+  if (width != n) {
+    std::vector<int64_t> padding(width - n, pad);
+    auto filler = builder.p2a(row(builder, padding, rows, type.fixed_point));
+    values = builder.concate({values, filler}, 1);
+  }
+  std::vector<int64_t> positions(width);
+  for (size_t i = 0; i < width; i++) {
+    positions[i] = static_cast<int64_t>(i) << type.fixed_point;
+  }
+  auto indices = builder.p2a(row(builder, positions, rows, type.fixed_point));
+  auto candidates = builder.concate({values, indices}, 0);
+
+  // merge pairs of sorted lists: a with b reversed is bitonic, the first
+  // compare_exchange splits it into a larger and a smaller bitonic half
+  for (size_t length = 1; width / length > 1;) {
+    size_t lists = width / length / 2;
+    auto pairs = reshape(builder, candidates, {2 * rows, lists, 2, length});
+    auto a = slice_along(builder, pairs, 2, 0, 1);
+    auto b = reverse_last(builder, slice_along(builder, pairs, 2, 1, 2));
+    auto [high, low] = compare_exchange(builder, a, b);
+    // past k candidates the smaller half is never needed again
+    size_t halves = 2 * length <= capacity ? 2 : 1;
+    auto merged = halves == 2 ? builder.concate({high, low}, 2) : high;
+    merged = reshape(builder, merged, {2 * rows, lists * halves, length});
+    width = lists * halves * length;
+    length *= halves;
+    candidates = reshape(builder, bitonic_clean(builder, merged),
+                         {2 * rows, width});
+  }
+
+  Shape result_shape = shape;
+  result_shape.back() = k;
+  auto top = slice_along(builder, candidates, 1, 0, k);
+  TopK result{
+      .values = reshape(builder, slice_along(builder, top, 0, 0, rows),
+                        result_shape),
+      .indices = reshape(builder, slice_along(builder, top, 0, rows, 2 * rows),
+                         result_shape),
+  };
+  builder.assume(result.values, range);
+  builder.assume(result.indices, Range{0, static_cast<double>(n - 1)});
+  return result;
+}
+
+auto argmax(ABPBuilder &builder, OpHandle x) -> OpHandle {
+  auto shape = builder.context().shape(x);
+  shape.pop_back();
+  return reshape(builder, top_k(builder, x, 1).indices, std::move(shape));
+}
+
+} // namespace fastmpc::abp
\ No newline at end of file
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+
+#include "fastmpc/abp/dialect/abp_builder.h"
+
+namespace fastmpc::abp {
+
+struct TopK {
+  // the k largest values of every row, in descending order
+  OpHandle values;
+  // their positions in the row, exact integers at the fixed point of x. Equal
+  // values come in no particular order.
+  OpHandle indices;
+};
+
+// The k largest values along the last dimension of x and where they are. Rows
+// are merged pairwise as sorted lists of up to bit_ceil(k) candidates, the
+// index of a candidate travels with its value: both are stacked in one tensor
+// and every comparison bit selects them in a single multiplication. All rows
+// share the same comparisons, ceil(log2(n)) merge levels of at most
+// 1 + log2(bit_ceil(k)) rounds of comparisons each.
+auto top_k(ABPBuilder &builder, OpHandle x, size_t k) -> TopK;
+
+// Position of the largest value along the last dimension of x, the first one
+// of equal maxima. A tournament of ceil(log2(n)) comparisons.
+auto argmax(ABPBuilder &builder, OpHandle x) -> OpHandle;
+
+} // namespace fastmpc::abp
\ No newline at end of file
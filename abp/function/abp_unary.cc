@@ -2,6 +2,8 @@
 
 #include <cmath>
 #include <cstdlib>
+#include <utility>
+#include <vector>
 
 #include "fastmpc/abp/dialect/abp_ops.h"
 #include "fastmpc/abp/function/abp_binary.h"
@@ -9,6 +11,8 @@
 #include "fastmpc/abp/function/abp_compare.h"
 #include "fastmpc/abp/function/abp_constant.h"
 #include "fastmpc/abp/function/abp_log2.h"
+#include "fastmpc/abp/function/abp_poly.h"
+#include "fastmpc/abp/function/abp_sqrt.h"
 
 namespace fastmpc::abp {
 
@@ -61,7 +65,9 @@ auto b2a(ABPBuilder &builder, OpHandle operand,
   }
 }
 
-auto exp(ABPBuilder &builder, OpHandle x) -> OpHandle {
+namespace {
+
+auto exp_squaring(ABPBuilder &builder, OpHandle x) {
   auto &context = builder.context();
   const size_t n = 12;
   auto left = builder.divide_pow_of_2(x, n);
@@ -78,6 +84,75 @@ auto exp(ABPBuilder &builder, OpHandle x) -> OpHandle {
   return result;
 }
 
+// Minimax polynomial of degree 5 for 2^f, f in [0, 1).
+auto exp2_fraction(ABPBuilder &builder, OpHandle f) {
+  return polynomial(builder, f,
+                    {
+                        0.999999925f,
+                        0.693153073f,
+                        0.240153617f,
+                        0.0558263180f,
+                        0.00898934009f,
+                        0.00187757667f,
+                    });
+}
+
+// e^x = 2^y with y = x * log2(e). Shifting y by fixed_point gives
+// t = int(y) + fixed_point, so 2^t is 2^int(y) already encoded in fixed point.
+// 2^t is the product of (1 + (2^(2^j) - 1) * bit_j(t)), the bits are read
+// from a single a2b of y. Results must stay below 2^(62 - 2 * fixed_point),
+// inputs below -fixed_point * ln(2) underflow to zero.
+auto exp_range_reduction(ABPBuilder &builder, OpHandle x) {
+  constexpr size_t kBits = 6;
+  uint8_t fixed_point = builder.fixed_point();
+  auto log2e = constant_like(builder, x, static_cast<float>(M_LOG2E));
+  auto y = multiply(builder, x, log2e);
+  y = add(builder, y, constant_like(builder, x, static_cast<float>(fixed_point)));
+  auto y_b = a2b(builder, y);
+
+  // quotients[j] = floor(t / 2^j)
+  std::vector<OpHandle> quotients;
+  for (size_t j = 0; j <= kBits; j++) {
+    auto shifted = builder.shift_right(y_b, fixed_point + j);
+    quotients.push_back(b2a(builder, shifted, 0));
+  }
+  auto sign = b2a(builder, builder.shift_right(y_b, 63), 0);
+
+  auto one = constant_like(builder, x, uint64_t{1});
+  auto two = constant_like(builder, x, uint64_t{2});
+  std::vector<OpHandle> factors;
+  for (size_t j = 0; j < kBits; j++) {
+    auto twice = multiply(builder, quotients[j + 1], two);
+    auto bit = subtract(builder, quotients[j], twice);
+    auto scale = constant_like(builder, x, (uint64_t{1} << (1u << j)) - 1);
+    factors.push_back(add(builder, one, multiply(builder, bit, scale)));
+  }
+  factors.push_back(subtract(builder, one, sign));
+
+  auto integer = multiply(builder, quotients[0], constant_like(builder, x, 1.0f));
+  auto fraction = subtract(builder, y, integer);
+  auto power = multiply_all(builder, std::move(factors));
+  auto result = multiply(builder, exp2_fraction(builder, fraction), power);
+  return builder.divide_pow_of_2(result, fixed_point);
+}
+
+} // namespace
+
+auto exp(ABPBuilder &builder, OpHandle x, ExpMode mode) -> OpHandle {
+  auto result = [&]() -> OpHandle {
+    switch (mode) {
+    case ExpMode::kSquaring:
+      return exp_squaring(builder, x);
+    case ExpMode::kRangeReduction:
+      return exp_range_reduction(builder, x);
+    default:
+      std::abort();
+    }
+  }();
+  builder.assume(result, Range::non_negative());
+  return result;
+}
+
 auto log(ABPBuilder &builder, OpHandle x) -> OpHandle {
   auto &context = builder.context();
   auto x_shape = context.type(x).shape;
@@ -90,9 +165,22 @@ auto log(ABPBuilder &builder, OpHandle x) -> OpHandle {
 }
 
 auto abs(ABPBuilder &builder, OpHandle x) -> OpHandle {
-  auto is_negative = msb(builder, x);
+  auto x_range = builder.context().range(x);
+  if (x_range.is_non_negative()) {
+    return x;
+  }
   auto x_neg = negate(builder, x);
-  return selectOne(builder, is_negative, x_neg, x);
+  if (x_range.is_negative()) {
+    return x_neg;
+  }
+  auto is_negative = msb(builder, x);
+  auto result = selectOne(builder, is_negative, x_neg, x);
+  builder.assume(result, Range{0, x_range.magnitude()});
+  return result;
+}
+
+auto sqrt(ABPBuilder &builder, OpHandle x) -> OpHandle {
+  return multiply(builder, x, rsqrt(builder, x));
 }
 
 } // namespace fastmpc::abp
\ No newline at end of file
@@ -9,7 +9,15 @@ namespace fastmpc::abp {
     auto a2b(ABPBuilder &builder, OpHandle operand) -> OpHandle;
     auto b2a(ABPBuilder &builder, OpHandle operand, uint8_t fixed_point) -> OpHandle;
 
-    auto exp(ABPBuilder &builder, OpHandle x) -> OpHandle;
+    enum class ExpMode {
+        // (1 + x / 2^12)^(2^12), 12 dependent multiplications
+        kSquaring,
+        // 2^int(y) from the bits of int(y) times a polynomial of frac(y),
+        // y = x * log2(e)
+        kRangeReduction,
+    };
+
+    auto exp(ABPBuilder &builder, OpHandle x, ExpMode mode = ExpMode::kSquaring) -> OpHandle;
     auto log(ABPBuilder &builder, OpHandle x) -> OpHandle;
     auto abs(ABPBuilder &builder, OpHandle x) -> OpHandle;
     auto sqrt(ABPBuilder &builder, OpHandle x) -> OpHandle;
@@ -3,6 +3,8 @@
 
 #include "fastmpc/abp/dialect/abp_builder.h"
 #include "fastmpc/abp/low/abp_lower.h"
+#include "fastmpc/abp/pass/abp_dce.h"
+#include "fastmpc/abp/pass/abp_truncation.h"
 
 namespace fastmpc::abp {
 
@@ -11,7 +13,8 @@ auto low(const pphlo::PPHLOContext &context) -> ABPContext {
   ABPBuilder builder(result, 15);
   ABPLower lower(context, builder);
   lower.run();
-  return result;
+  // transposes folded into matrix products are left behind by the builder
+  return eliminate_dead_ops(sink_truncations(result));
 }
 
 }
\ No newline at end of file
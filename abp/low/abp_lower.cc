@@ -1,6 +1,8 @@
 #include "fastmpc/abp/low/abp_lower.h"
 
+#include <algorithm>
 #include <cassert>
+#include <iterator>
 #include <utility>
 #include <vector>
 
@@ -18,6 +20,8 @@
 #include "mlir/IR/Operation.h"
 #include "mlir/IR/Region.h"
 #include "mlir/IR/Types.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/Support/Casting.h"
 
 namespace fastmpc::abp {
@@ -43,6 +47,25 @@ auto collect(const mlir::DenseIntElementsAttr &attr) {
   auto values = attr.getValues<size_t>();
   return DenseSizeT(values.begin(), values.end());
 }
+
+// A secret product whose only user sums it over a single dimension is lowered
+// together with that reduction as an inner product, so the cross terms are
+// summed before resharing and the result is truncated once.
+auto is_inner_product(mlir::pphlo::MulOp op) -> bool {
+  if (!op.getResult().hasOneUse() || is_public(op.getOperand(0).getType()) ||
+      is_public(op.getOperand(1).getType())) {
+    return false;
+  }
+  auto reduce =
+      llvm::dyn_cast<mlir::pphlo::ReduceOp>(*op.getResult().getUsers().begin());
+  if (!reduce || reduce.getInputs().size() != 1 ||
+      reduce.getDimensions().size() != 1) {
+    return false;
+  }
+  auto body = reduce.getBody().front().without_terminator();
+  return std::distance(body.begin(), body.end()) == 1 &&
+         llvm::isa<mlir::pphlo::AddOp>(*body.begin());
+}
 } // namespace
 
 void ABPLower::run() {
@@ -110,10 +133,14 @@ void ABPLower::low(mlir::Operation *in) {
     low_divide(&op);
   } else if (auto op = cast(DotGeneralOp)) {
     low_dot_general(&op);
+  } else if (auto op = cast(DynamicSliceOp)) {
+    low_dynamic_slice(&op);
   } else if (auto op = cast(EqualOp)) {
     low_equal(&op);
   } else if (auto op = cast(ExpOp)) {
     low_exponential(&op);
+  } else if (auto op = cast(GatherOp)) {
+    low_gather(&op);
   } else if (auto op = cast(GreaterOp)) {
     low_greater(&op);
   } else if (auto op = cast(GreaterEqualOp)) {
@@ -124,6 +151,8 @@ void ABPLower::low(mlir::Operation *in) {
     low_less(&op);
   } else if (auto op = cast(LogOp)) {
     low_log(&op);
+  } else if (auto op = cast(LogisticOp)) {
+    low_logistic(&op);
   } else if (auto op = cast(MaxOp)) {
     low_maximum(&op);
   } else if (auto op = cast(MulOp)) {
@@ -156,6 +185,8 @@ void ABPLower::low(mlir::Operation *in) {
     low_sqrt(&op);
   } else if (auto op = cast(SubtractOp)) {
     low_subtract(&op);
+  } else if (auto op = cast(TanhOp)) {
+    low_tanh(&op);
   } else if (auto op = cast(TransposeOp)) {
     low_transpose(&op);
   } else if (auto op = llvm::dyn_cast<mlir::func::ReturnOp>(in)) {
@@ -187,6 +218,10 @@ void ABPLower::low_subtract(mlir::pphlo::SubtractOp *op) {
 }
 
 void ABPLower::low_multiply(mlir::pphlo::MulOp *op) {
+  if (is_inner_product(*op)) {
+    // lowered by `low_reduce`
+    return;
+  }
   auto left = map_.find(op->getOperand(0))->second;
   auto right = map_.find(op->getOperand(1))->second;
   auto result = multiply(*builder_, left, right);
@@ -338,13 +373,6 @@ void ABPLower::low_iota(mlir::pphlo::IotaOp *op) {
   map_.try_emplace(op->getResult(), result);
 }
 
-void ABPLower::low_transpose(mlir::pphlo::TransposeOp *op) {
-  auto operand = map_.find(op->getOperand())->second;
-  auto permutation = collect(op->getPermutation());
-  auto result = builder_->transpose(operand, ~permutation);
-  map_.try_emplace(op->getResult(), result);
-}
-
 void ABPLower::low_divide(mlir::pphlo::DivOp *op) {
   auto left = map_.find(op->getOperand(0))->second;
   auto right = map_.find(op->getOperand(1))->second;
@@ -352,37 +380,339 @@ void ABPLower::low_divide(mlir::pphlo::DivOp *op) {
   map_.try_emplace(op->getResult(), result);
 }
 
+void ABPLower::low_rsqrt(mlir::pphlo::RsqrtOp *op) {
+  auto operand = map_.find(op->getOperand())->second;
+  auto result = rsqrt(*builder_, operand);
+  map_.try_emplace(op->getResult(), result);
+}
+
+void ABPLower::low_sqrt(mlir::pphlo::SqrtOp *op) {
+  auto operand = map_.find(op->getOperand())->second;
+  auto result = sqrt(*builder_, operand);
+  map_.try_emplace(op->getResult(), result);
+}
+
 void ABPLower::low_exponential(mlir::pphlo::ExpOp *op) {
   auto operand = map_.find(op->getOperand())->second;
   auto result = exp(*builder_, operand);
   map_.try_emplace(op->getResult(), result);
 }
 
+void ABPLower::low_logistic(mlir::pphlo::LogisticOp *op) {
+  auto operand = map_.find(op->getOperand())->second;
+  auto result = sigmoid(*builder_, operand);
+  map_.try_emplace(op->getResult(), result);
+}
+
+void ABPLower::low_tanh(mlir::pphlo::TanhOp *op) {
+  auto operand = map_.find(op->getOperand())->second;
+  auto result = tanh(*builder_, operand);
+  map_.try_emplace(op->getResult(), result);
+}
+
+namespace {
+
+// `operand` with its dimensions taken in `order`: dimension i of the result is
+// dimension order[i] of the operand. ABPBuilder::transpose takes the position
+// of every operand dimension instead.
+auto permute(ABPBuilder &builder, OpHandle operand,
+             const std::vector<size_t> &order) -> OpHandle {
+  if (std::is_sorted(order.begin(), order.end())) {
+    return operand;
+  }
+  DenseSizeT permutation(order.size());
+  for (size_t i = 0; i < order.size(); i++) {
+    permutation[order[i]] = i;
+  }
+  return builder.transpose(operand, ~permutation);
+}
+
+auto window_values(mlir::DenseIntElementsAttr attr) {
+  std::vector<int64_t> values;
+  if (attr) {
+    auto elements = attr.getValues<int64_t>();
+    values.assign(elements.begin(), elements.end());
+  }
+  return values;
+}
+
+// padding holds the low and high padding of every dimension in turn
+auto conv_window(mlir::DenseIntElementsAttr strides,
+                 mlir::DenseIntElementsAttr padding,
+                 mlir::DenseIntElementsAttr dilation) -> ConvWindow {
+  ConvWindow result;
+  for (auto stride : window_values(strides)) {
+    result.strides.push_back(stride);
+  }
+  auto pairs = window_values(padding);
+  for (size_t i = 0; i + 1 < pairs.size(); i += 2) {
+    assert(pairs[i] >= 0 && pairs[i + 1] >= 0);
+    result.padding.emplace_back(pairs[i], pairs[i + 1]);
+  }
+  for (auto step : window_values(dilation)) {
+    result.dilation.push_back(step);
+  }
+  return result;
+}
+
+} // namespace
+
+// pphlo names the operand dimension of every result dimension
+void ABPLower::low_transpose(mlir::pphlo::TransposeOp *op) {
+  auto operand = map_.find(op->getOperand())->second;
+  auto permutation = collect(op->getPermutation());
+  std::vector<size_t> order(permutation.begin(), permutation.end());
+  auto result = permute(*builder_, operand, order);
+  map_.try_emplace(op->getResult(), result);
+}
+
 // Warning: I have hacked pphlo.BroadcastOp's lowing function to make this code
 // work!!!
+//
+// The operands are brought to [batch..., free, contracting] and [batch...,
+// contracting, free], so all batches, such as the heads of an attention, go
+// through one dot_general.
 void ABPLower::low_dot_general(mlir::pphlo::DotGeneralOp *op) {
   auto &context = builder_->context();
   auto dim_numbers = op->getDotDimensionNumbers();
   auto lhs = map_.find(op->getLhs())->second;
   auto rhs = map_.find(op->getRhs())->second;
-  auto left_type = context.type(lhs);
-  auto right_type = context.type(rhs);
-  auto &left_shape = context.shape(left_type.shape);
-  auto &right_shape = context.shape(right_type.shape);
-  assert(left_shape.size() == 2);
-  assert(right_shape.size() == 2);
-  assert(dim_numbers.getLhsContractingDimensions().size() == 1);
-  assert(dim_numbers.getRhsContractingDimensions().size() == 1);
-  size_t left_contract = dim_numbers.getLhsContractingDimensions()[0];
-  size_t right_contract = dim_numbers.getRhsContractingDimensions()[0];
-
-  if (left_contract == 0) {
-    lhs = builder_->transpose(lhs, {1, 0});
-  }
-  if (right_contract == 1) {
-    rhs = builder_->transpose(rhs, {1, 0});
-  }
-  auto result = dot_general(*builder_, lhs, rhs);
+  auto left_shape = context.shape(lhs);
+  auto right_shape = context.shape(rhs);
+  auto left_batch = dim_numbers.getLhsBatchingDimensions();
+  auto right_batch = dim_numbers.getRhsBatchingDimensions();
+  auto left_contract = dim_numbers.getLhsContractingDimensions();
+  auto right_contract = dim_numbers.getRhsContractingDimensions();
+  assert(left_batch.size() == right_batch.size());
+  assert(left_contract.size() == right_contract.size());
+
+  // batch dimensions, then `tail` after the remaining ones in order
+  auto arrange = [](size_t rank, llvm::ArrayRef<int64_t> batch,
+                    llvm::ArrayRef<int64_t> tail, bool tail_first) {
+    std::vector<size_t> order(batch.begin(), batch.end());
+    std::vector<size_t> free;
+    for (int64_t i = 0; i < static_cast<int64_t>(rank); i++) {
+      if (!llvm::is_contained(batch, i) && !llvm::is_contained(tail, i)) {
+        free.push_back(i);
+      }
+    }
+    if (tail_first) {
+      order.insert(order.end(), tail.begin(), tail.end());
+      order.insert(order.end(), free.begin(), free.end());
+    } else {
+      order.insert(order.end(), free.begin(), free.end());
+      order.insert(order.end(), tail.begin(), tail.end());
+    }
+    return order;
+  };
+  auto elements = [](const Shape &shape, llvm::ArrayRef<int64_t> dims) {
+    size_t result = 1;
+    for (auto dim : dims) {
+      result *= shape[dim];
+    }
+    return result;
+  };
+
+  // [batch..., rows, inner] x [batch..., inner, columns]
+  Shape batch_shape;
+  for (auto dim : left_batch) {
+    batch_shape.push_back(left_shape[dim]);
+  }
+  size_t inner = elements(left_shape, left_contract);
+  size_t rows = 1;
+  for (auto size : left_shape) {
+    rows *= size;
+  }
+  rows /= elements(left_shape, left_batch) * inner;
+  size_t columns = 1;
+  for (auto size : right_shape) {
+    columns *= size;
+  }
+  columns /= elements(right_shape, right_batch) * inner;
+
+  // An operand already laid out with its two matrix dimensions the other way
+  // around is read transposed by the product instead of being permuted.
+  auto matrices = [&](OpHandle operand, size_t rank,
+                      llvm::ArrayRef<int64_t> batch,
+                      llvm::ArrayRef<int64_t> contract, bool contract_first,
+                      size_t first, size_t second, bool &transposed) {
+    auto order = arrange(rank, batch, contract, contract_first);
+    auto flipped = arrange(rank, batch, contract, !contract_first);
+    transposed = !std::is_sorted(order.begin(), order.end()) &&
+                 std::is_sorted(flipped.begin(), flipped.end());
+    if (transposed) {
+      std::swap(first, second);
+    } else {
+      operand = permute(*builder_, operand, order);
+    }
+    Shape shape = batch_shape;
+    shape.push_back(first);
+    shape.push_back(second);
+    if (context.shape(operand) != shape) {
+      operand = builder_->reshape(operand, builder_->push(std::move(shape)));
+    }
+    return operand;
+  };
+  bool transpose_left = false;
+  bool transpose_right = false;
+  lhs = matrices(lhs, left_shape.size(), left_batch, left_contract, false,
+                 rows, inner, transpose_left);
+  rhs = matrices(rhs, right_shape.size(), right_batch, right_contract, true,
+                 inner, columns, transpose_right);
+
+  // [batch..., left free..., right free...]
+  auto result =
+      dot_general(*builder_, lhs, rhs, transpose_left, transpose_right);
+  auto shape = shape_of(op->getType());
+  if (context.shape(result) != shape) {
+    result = builder_->reshape(result, builder_->push(~shape));
+  }
+  map_.try_emplace(op->getResult(), result);
+}
+
+// Gathers that take whole slices along a single operand dimension, as
+// embedding lookups do: every public index picks `size` entries of that
+// dimension and all entries of the others. The dimension is moved to the
+// front for GatherOp, the result is then arranged as pphlo places the offset
+// dimensions.
+void ABPLower::low_gather(mlir::pphlo::GatherOp *op) {
+  auto &context = builder_->context();
+  assert(is_public(op->getStartIndices().getType()));
+  auto operand = map_.find(op->getOperand())->second;
+  auto indices = map_.find(op->getStartIndices())->second;
+  auto numbers = op->getDimensionNumbers();
+  auto start_map = numbers.getStartIndexMap();
+  auto collapsed = numbers.getCollapsedSliceDims();
+  auto offset_dims = numbers.getOffsetDims();
+  auto sizes = collect(op->getSliceSizes());
+  auto shape = context.shape(operand);
+  assert(start_map.size() == 1);
+  size_t axis = start_map[0];
+  for (size_t i = 0; i < shape.size(); i++) {
+    assert(i == axis || sizes[i] == shape[i]);
+  }
+
+  // the index vector holds a single start and is dropped
+  auto index_shape = context.shape(indices);
+  size_t vector_dim = numbers.getIndexVectorDim();
+  if (vector_dim < index_shape.size()) {
+    assert(index_shape[vector_dim] == 1);
+    index_shape.erase(index_shape.begin() + vector_dim);
+    indices = builder_->reshape(indices, builder_->push(Shape(index_shape)));
+  }
+
+  // [indices..., size, the other operand dimensions...]
+  std::vector<size_t> order{axis};
+  for (size_t i = 0; i < shape.size(); i++) {
+    if (i != axis) {
+      order.push_back(i);
+    }
+  }
+  auto result = builder_->gather(permute(*builder_, operand, order), indices,
+                                 sizes[axis]);
+
+  // position in the gathered tensor of every operand dimension
+  size_t batch = index_shape.size();
+  std::vector<size_t> position(shape.size());
+  for (size_t i = 0; i < order.size(); i++) {
+    position[order[i]] = batch + i;
+  }
+  // offset dimensions are the uncollapsed operand dimensions in order, the
+  // batch dimensions fill the rest; collapsed ones have size 1 and go last
+  std::vector<size_t> slices;
+  std::vector<size_t> dropped;
+  for (size_t i = 0; i < shape.size(); i++) {
+    if (llvm::is_contained(collapsed, static_cast<int64_t>(i))) {
+      dropped.push_back(position[i]);
+    } else {
+      slices.push_back(position[i]);
+    }
+  }
+  std::vector<size_t> result_order;
+  for (size_t i = 0, b = 0, k = 0; i < batch + slices.size(); i++) {
+    bool is_offset = llvm::is_contained(offset_dims, static_cast<int64_t>(i));
+    result_order.push_back(is_offset ? slices[k++] : b++);
+  }
+  result_order.insert(result_order.end(), dropped.begin(), dropped.end());
+  result = permute(*builder_, result, result_order);
+  auto result_shape = shape_of(op->getType());
+  if (context.shape(result) != result_shape) {
+    result = builder_->reshape(result, builder_->push(~result_shape));
+  }
+  map_.try_emplace(op->getResult(), result);
+}
+
+// One gather of a single slice per dimension that is not taken whole, the
+// start of each is a public scalar.
+void ABPLower::low_dynamic_slice(mlir::pphlo::DynamicSliceOp *op) {
+  auto &context = builder_->context();
+  auto result = map_.find(op->getOperand())->second;
+  auto sizes = collect(op->getSliceSizes());
+  auto starts = op->getStartIndices();
+  for (size_t d = 0; d < sizes.size(); d++) {
+    auto shape = context.shape(result);
+    if (sizes[d] == shape[d]) {
+      continue;
+    }
+    assert(is_public(starts[d].getType()));
+    auto start = map_.find(starts[d])->second;
+    // dimension d to the front and back again
+    std::vector<size_t> order{d};
+    for (size_t i = 0; i < shape.size(); i++) {
+      if (i != d) {
+        order.push_back(i);
+      }
+    }
+    std::vector<size_t> back(order.size());
+    for (size_t i = 0; i < order.size(); i++) {
+      back[order[i]] = i;
+    }
+    auto slice = builder_->gather(permute(*builder_, result, order), start,
+                                  sizes[d]);
+    result = permute(*builder_, slice, back);
+  }
+  map_.try_emplace(op->getResult(), result);
+}
+
+// The input is brought to [batch, spatial..., feature] and the kernel to
+// [spatial..., input feature, output feature], then `convolution` gathers the
+// patches and multiplies them with the kernel in one dot_general.
+void ABPLower::low_convolution(mlir::pphlo::ConvolutionOp *op) {
+  auto lhs = map_.find(op->getLhs())->second;
+  auto rhs = map_.find(op->getRhs())->second;
+  auto numbers = op->getDimensionNumbers();
+  assert(op->getFeatureGroupCount() == 1 && op->getBatchGroupCount() == 1);
+  for (auto dilation : window_values(op->getLhsDilationAttr())) {
+    assert(dilation == 1);
+  }
+
+  auto input_spatial = numbers.getInputSpatialDimensions();
+  std::vector<size_t> input_order{
+      static_cast<size_t>(numbers.getInputBatchDimension())};
+  input_order.insert(input_order.end(), input_spatial.begin(),
+                     input_spatial.end());
+  input_order.push_back(numbers.getInputFeatureDimension());
+
+  std::vector<size_t> kernel_order(numbers.getKernelSpatialDimensions().begin(),
+                                   numbers.getKernelSpatialDimensions().end());
+  kernel_order.push_back(numbers.getKernelInputFeatureDimension());
+  kernel_order.push_back(numbers.getKernelOutputFeatureDimension());
+
+  auto window = conv_window(op->getWindowStridesAttr(), op->getPaddingAttr(),
+                            op->getRhsDilationAttr());
+
+  auto result = convolution(*builder_, permute(*builder_, lhs, input_order),
+                            permute(*builder_, rhs, kernel_order), window);
+
+  // position of every output dimension in [batch, spatial..., feature]
+  auto output_spatial = numbers.getOutputSpatialDimensions();
+  std::vector<size_t> output_order(output_spatial.size() + 2);
+  output_order[numbers.getOutputBatchDimension()] = 0;
+  for (size_t i = 0; i < output_spatial.size(); i++) {
+    output_order[output_spatial[i]] = i + 1;
+  }
+  output_order[numbers.getOutputFeatureDimension()] = output_order.size() - 1;
+  result = permute(*builder_, result, output_order);
   map_.try_emplace(op->getResult(), result);
 }
 
@@ -415,6 +745,21 @@ void ABPLower::low_concatenate(mlir::pphlo::ConcatenateOp *op) {
 void ABPLower::low_reduce(mlir::pphlo::ReduceOp *op) {
   assert(op->getNumResults() == 1);
   auto reduce_dims = collect(op->getDimensions());
+  if (auto mul = op->getInputs()[0].getDefiningOp<mlir::pphlo::MulOp>();
+      mul && is_inner_product(mul)) {
+    auto left = map_.find(mul.getOperand(0))->second;
+    auto right = map_.find(mul.getOperand(1))->second;
+    auto init = map_.find(op->getInitValues()[0])->second;
+    auto result = dot_product(*builder_, left, right, reduce_dims[0]);
+    auto type = builder_->context().type(result);
+    result = add(*builder_, result, builder_->broadcast(init, {}, type.shape));
+    auto shape = shape_of(op->getType(0));
+    if (builder_->context().shape(result) != shape) {
+      result = builder_->reshape(result, builder_->push(~shape));
+    }
+    map_.try_emplace(op->getResult(0), result);
+    return;
+  }
   std::vector<OpHandle> inputs;
   for (auto value : op->getInputs()) {
     inputs.push_back(map_.find(value)->second);
@@ -447,6 +792,49 @@ void ABPLower::low_reduce(mlir::pphlo::ReduceOp *op) {
   map_.try_emplace(op->getResult(0), result);
 }
 
+// Windows reduced by a single add or max in the body. The padding of a max
+// takes the init value as its identity, -inf does not fit the fixed point and
+// max_pool pads below the range of the input instead.
+void ABPLower::low_reduce_window(mlir::pphlo::ReduceWindowOp *op) {
+  assert(op->getInputs().size() == 1 && op->getInitValues().size() == 1);
+  auto input = map_.find(op->getInputs()[0])->second;
+  auto init = map_.find(op->getInitValues()[0])->second;
+  for (auto dilation : window_values(op->getBaseDilationsAttr())) {
+    assert(dilation == 1);
+  }
+
+  auto dimensions = window_values(op->getWindowDimensionsAttr());
+  Shape window(dimensions.begin(), dimensions.end());
+  auto conv = conv_window(op->getWindowStridesAttr(), op->getPaddingAttr(),
+                          op->getWindowDilationsAttr());
+
+  auto &block = op->getBody().front();
+  auto body = block.without_terminator();
+  assert(std::distance(body.begin(), body.end()) == 1);
+  // every window is combined with the init value, as reduce does. A zero
+  // init of a sum and an init below the range of a max are dropped.
+  auto result = [&]() -> OpHandle {
+    if (llvm::isa<mlir::pphlo::AddOp>(*body.begin())) {
+      auto pooled = sum_pool(*builder_, input, window, conv);
+      auto init_range = context().range(init);
+      if (init_range.lower == 0 && init_range.upper == 0) {
+        return pooled;
+      }
+      auto shape = context().type(pooled).shape;
+      return add(*builder_, pooled, builder_->broadcast(init, {}, shape));
+    }
+    if (llvm::isa<mlir::pphlo::MaxOp>(*body.begin())) {
+      auto pooled = max_pool(*builder_, input, window, conv);
+      auto shape = context().type(pooled).shape;
+      return maximize(*builder_, pooled, builder_->broadcast(init, {}, shape));
+    }
+    llvm::errs() << body.begin()->getName()
+                 << " is not supported in reduceWindowOp!\n";
+    std::abort();
+  }();
+  map_.try_emplace(op->getResult(0), result);
+}
+
 void ABPLower::unsupported(mlir::Operation *op) {
   llvm::errs() << op->getName() << " is not supported!\n";
   std::abort();
@@ -454,14 +842,10 @@ void ABPLower::unsupported(mlir::Operation *op) {
 
 #define MARK_UNSUPPORTED(FuncName, OpName)                                     \
   void ABPLower::FuncName(mlir::pphlo::OpName *op) { unsupported(*op); }
-MARK_UNSUPPORTED(low_convolution, ConvolutionOp)
 MARK_UNSUPPORTED(low_pad, PadOp)
 MARK_UNSUPPORTED(low_power, PowOp)
-MARK_UNSUPPORTED(low_reduce_window, ReduceWindowOp)
 MARK_UNSUPPORTED(low_return, ReturnOp) // today
 MARK_UNSUPPORTED(low_reverse, ReverseOp)
-MARK_UNSUPPORTED(low_rsqrt, RsqrtOp)
 MARK_UNSUPPORTED(low_select_and_scatter, SelectAndScatterOp)
-MARK_UNSUPPORTED(low_sqrt, SqrtOp)
 
 } // namespace fastmpc::abp
\ No newline at end of file
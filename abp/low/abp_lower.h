@@ -25,13 +25,16 @@ class ConvertOp;
 class ConvolutionOp;
 class DivOp;
 class DotGeneralOp;
+class DynamicSliceOp;
 class EqualOp;
 class ExpOp;
+class GatherOp;
 class GreaterOp;
 class GreaterEqualOp;
 class IotaOp;
 class LessOp;
 class LogOp;
+class LogisticOp;
 class MaxOp;
 class MulOp;
 class NegOp;
@@ -48,6 +51,7 @@ class SelectAndScatterOp;
 class SliceOp;
 class SqrtOp;
 class SubtractOp;
+class TanhOp;
 class TransposeOp;
 } // namespace mlir::pphlo
 
@@ -79,13 +83,16 @@ private:
   void low_convolution(mlir::pphlo::ConvolutionOp *);
   void low_divide(mlir::pphlo::DivOp *);
   void low_dot_general(mlir::pphlo::DotGeneralOp *);
+  void low_dynamic_slice(mlir::pphlo::DynamicSliceOp *);
   void low_equal(mlir::pphlo::EqualOp *);
   void low_exponential(mlir::pphlo::ExpOp *);
+  void low_gather(mlir::pphlo::GatherOp *);
   void low_greater(mlir::pphlo::GreaterOp *);
   void low_greater_equal(mlir::pphlo::GreaterEqualOp *);
   void low_iota(mlir::pphlo::IotaOp *);
   void low_less(mlir::pphlo::LessOp *);
   void low_log(mlir::pphlo::LogOp *);
+  void low_logistic(mlir::pphlo::LogisticOp *);
   void low_maximum(mlir::pphlo::MaxOp *);
   void low_multiply(mlir::pphlo::MulOp *);
   void low_negate(mlir::pphlo::NegOp *);
@@ -102,6 +109,7 @@ private:
   void low_slice(mlir::pphlo::SliceOp *);
   void low_sqrt(mlir::pphlo::SqrtOp *);
   void low_subtract(mlir::pphlo::SubtractOp *);
+  void low_tanh(mlir::pphlo::TanhOp *);
   void low_transpose(mlir::pphlo::TransposeOp *);
   void unsupported(mlir::Operation *);
 
@@ -0,0 +1,44 @@
+#include "fastmpc/abp/pass/abp_dce.h"
+
+#include <type_traits>
+#include <vector>
+
+#include "fastmpc/abp/dialect/abp_builder.h"
+#include "fastmpc/abp/dialect/abp_ops.h"
+
+namespace fastmpc::abp {
+
+auto eliminate_dead_ops(const ABPContext &source) -> ABPContext {
+  // operands are created before their users, one pass back from the outputs
+  std::vector<bool> live(source.ops_size(), false);
+  for (size_t i = source.ops_size(); i-- > 0;) {
+    OpHandle handle(i);
+    bool is_output = source.visit(handle, [](OpHandle, auto &&op) {
+      return std::is_same_v<std::decay_t<decltype(op)>, OutputOp>;
+    });
+    if (!is_output && !live[i]) {
+      continue;
+    }
+    live[i] = true;
+    for (auto operand : source.operands(handle)) {
+      live[operand.unwarp()] = true;
+    }
+  }
+
+  ABPContext result;
+  ABPBuilder builder(result, 0);
+  std::vector<OpHandle> values(source.ops_size(), OpHandle(0));
+  for (size_t i = 0; i < source.ops_size(); i++) {
+    if (!live[i]) {
+      continue;
+    }
+    std::vector<OpHandle> operands;
+    for (auto operand : source.operands(OpHandle(i))) {
+      operands.push_back(values[operand.unwarp()]);
+    }
+    values[i] = builder.clone(source, OpHandle(i), std::move(operands));
+  }
+  return result;
+}
+
+} // namespace fastmpc::abp
\ No newline at end of file
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "fastmpc/abp/dialect/abp_context.h"
+
+namespace fastmpc::abp {
+
+// `source` without the ops no output depends on, such as a transpose that
+// ABPBuilder folded into the flag of a matrix product.
+auto eliminate_dead_ops(const ABPContext &source) -> ABPContext;
+
+} // namespace fastmpc::abp
\ No newline at end of file
@@ -0,0 +1,193 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "fastmpc/abp/analysis/abp_cost.h"
+#include "fastmpc/abp/dialect/abp_builder.h"
+#include "fastmpc/abp/executor/abp_executor.h"
+#include "fastmpc/abp/pass/abp_dce.h"
+#include "fastmpc/abp/pass/abp_truncation.h"
+#include "fastmpc/eager/tensor.h"
+
+using namespace fastmpc::abp;
+using namespace fastmpc;
+
+namespace {
+
+constexpr uint8_t kFixedPoint = 12;
+// bound on the inputs
+constexpr double kBound = 16;
+
+auto encode(float value) -> uint64_t {
+  return static_cast<uint64_t>(
+      static_cast<int64_t>(value * (1 << kFixedPoint)));
+}
+
+auto decode(uint64_t value) -> float {
+  return static_cast<float>(static_cast<int64_t>(value)) / (1 << kFixedPoint);
+}
+
+auto secret(ABPBuilder &builder, size_t index) {
+  Type type{
+      .kind = TypeKind::kArithFixed64,
+      .fixed_point = kFixedPoint,
+      .shape = builder.push(Shape{}),
+  };
+  auto result = builder.input(index, type);
+  builder.assume(result, Range{-kBound, kBound});
+  return result;
+}
+
+auto constant(ABPBuilder &builder, float value) {
+  Type type{
+      .kind = TypeKind::kFixed64,
+      .fixed_point = kFixedPoint,
+      .shape = builder.push(Shape{}),
+  };
+  DenseValue dense_value(1);
+  dense_value[0] = encode(value);
+  return builder.constant(builder.push(std::move(dense_value)), type);
+}
+
+auto run(const ABPContext &context, float x, float y) -> float {
+  ABPExecutor executor(context, 2, 1);
+  eager::Tensor left;
+  *left.data() = encode(x);
+  eager::Tensor right;
+  *right.data() = encode(y);
+  executor.input(0) = left;
+  executor.input(1) = right;
+  executor.run();
+  return decode(executor.output(0).data()[0]);
+}
+
+} // namespace
+
+// ((x * 1.5) * -0.75 + y * 2) * 0.5, every product truncated
+TEST(abp_pass_test, sink_truncations) {
+  ABPContext context;
+  ABPBuilder builder(context, kFixedPoint);
+  auto x = secret(builder, 0);
+  auto y = secret(builder, 1);
+  auto t = builder.truncate_a(builder.multiply_ap(x, constant(builder, 1.5f)),
+                              kFixedPoint);
+  t = builder.truncate_a(builder.multiply_ap(t, constant(builder, -0.75f)),
+                         kFixedPoint);
+  auto u = builder.truncate_a(builder.multiply_ap(y, constant(builder, 2.f)),
+                              kFixedPoint);
+  auto result = builder.truncate_a(
+      builder.multiply_ap(builder.add_aa(t, u), constant(builder, 0.5f)),
+      kFixedPoint);
+  builder.output(result, 0);
+
+  auto sunk = sink_truncations(context);
+  EXPECT_NEAR(run(sunk, 1.25f, -3.5f), run(context, 1.25f, -3.5f), 1e-3);
+  EXPECT_NEAR(run(sunk, 1.25f, -3.5f), -4.203125f, 1e-3);
+
+  auto cost = estimate_cost(context);
+  auto sunk_cost = estimate_cost(sunk);
+  EXPECT_EQ(cost.rounds, 3u);
+  EXPECT_EQ(sunk_cost.rounds, 1u);
+  EXPECT_LT(sunk_cost.bytes, cost.bytes);
+}
+
+// x * y + y * y, both truncations are fused into their products
+TEST(abp_pass_test, keep_fused_truncations) {
+  ABPContext context;
+  ABPBuilder builder(context, kFixedPoint);
+  auto x = secret(builder, 0);
+  auto y = secret(builder, 1);
+  auto left = builder.truncate_a(builder.multiply_aa(x, y), kFixedPoint);
+  auto right = builder.truncate_a(builder.multiply_aa(y, y), kFixedPoint);
+  builder.output(builder.add_aa(left, right), 0);
+
+  auto sunk = sink_truncations(context);
+  EXPECT_NEAR(run(sunk, 0.5f, -2.f), -1.f + 4.f, 1e-3);
+  auto cost = estimate_cost(context);
+  auto sunk_cost = estimate_cost(sunk);
+  EXPECT_EQ(sunk_cost.rounds, cost.rounds);
+  EXPECT_EQ(sunk_cost.bytes, cost.bytes);
+}
+
+// a deferred truncation is materialized when the range does not fit below the
+// truncation mask
+TEST(abp_pass_test, respect_headroom) {
+  ABPContext context;
+  ABPBuilder builder(context, kFixedPoint);
+  auto x = secret(builder, 0);
+  auto t = x;
+  for (size_t i = 0; i < 4; i++) {
+    t = builder.truncate_a(builder.multiply_ap(t, constant(builder, 1.5f)),
+                           kFixedPoint);
+  }
+  builder.output(t, 0);
+
+  // 12 + 4 * 12 fractional bits and the 7 integer bits of 16 * 1.5^4 do not
+  // fit
+  auto sunk = sink_truncations(context);
+  EXPECT_NEAR(run(sunk, 2.f, 0.f), 2.f * 1.5f * 1.5f * 1.5f * 1.5f, 1e-2);
+  EXPECT_GT(estimate_cost(sunk).rounds, 1u);
+  EXPECT_LT(estimate_cost(sunk).rounds, estimate_cost(context).rounds);
+}
+
+// without a bound on the input nothing is deferred
+TEST(abp_pass_test, unknown_range) {
+  ABPContext context;
+  ABPBuilder builder(context, kFixedPoint);
+  Type type{
+      .kind = TypeKind::kArithFixed64,
+      .fixed_point = kFixedPoint,
+      .shape = builder.push(Shape{}),
+  };
+  auto x = builder.input(0, type);
+  auto t = builder.truncate_a(builder.multiply_ap(x, constant(builder, 1.5f)),
+                              kFixedPoint);
+  t = builder.truncate_a(builder.multiply_ap(t, constant(builder, 0.5f)),
+                         kFixedPoint);
+  builder.output(t, 0);
+
+  auto sunk = sink_truncations(context);
+  EXPECT_EQ(estimate_cost(sunk).rounds, estimate_cost(context).rounds);
+}
+
+// the transpose folded into the product and an unused op are dropped
+TEST(abp_pass_test, eliminate_dead_ops) {
+  ABPContext context;
+  ABPBuilder builder(context, kFixedPoint);
+  Type type{
+      .kind = TypeKind::kArithFixed64,
+      .fixed_point = kFixedPoint,
+      .shape = builder.push(Shape{2, 2}),
+  };
+  auto x = builder.input(0, type);
+  auto y = builder.input(1, type);
+  auto product = builder.dot_general_aa(builder.transpose(x, {1, 0}), y);
+  builder.negate_a(y);
+  builder.output(product, 0);
+
+  auto live = eliminate_dead_ops(context);
+  EXPECT_EQ(live.ops_size(), context.ops_size() - 2);
+  for (size_t i = 0; i < live.ops_size(); i++) {
+    live.visit(OpHandle(i), [](OpHandle, auto &&op) {
+      using T = std::decay_t<decltype(op)>;
+      EXPECT_FALSE((std::is_same_v<T, TransposeOp>));
+      EXPECT_FALSE((std::is_same_v<T, NegateAOp>));
+    });
+  }
+
+  const uint64_t values[] = {encode(1), encode(2), encode(-1), encode(0.5f)};
+  auto result = [&](const ABPContext &program) {
+    ABPExecutor executor(program, 2, 1);
+    auto tensor = eager::Tensor::with_shape({2, 2});
+    std::copy(values, values + 4, tensor.data());
+    executor.input(0) = tensor;
+    executor.input(1) = tensor;
+    executor.run();
+    auto output = executor.output(0);
+    return std::vector<uint64_t>(output.data(), output.data() + 4);
+  };
+  EXPECT_EQ(result(live), result(context));
+}
\ No newline at end of file
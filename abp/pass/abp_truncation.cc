@@ -0,0 +1,299 @@
+#include "fastmpc/abp/pass/abp_truncation.h"
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+#include "fastmpc/abp/dialect/abp_builder.h"
+#include "fastmpc/abp/dialect/abp_ops.h"
+#include "fastmpc/abp/dialect/abp_range.h"
+
+namespace fastmpc::abp {
+
+namespace {
+
+// The value of a source op is `handle` shifted right by `shift` bits, the
+// fixed point of `handle` is the one of the source op plus `shift`.
+struct Lazy {
+  OpHandle handle;
+  uint8_t shift;
+};
+
+class TruncationSinking {
+public:
+  TruncationSinking(const ABPContext &source, ABPContext &target)
+      : source_(&source), builder_(target, 0), uses_(source.ops_size(), 0) {
+    for (size_t i = 0; i < source.ops_size(); i++) {
+      for (auto operand : source.operands(OpHandle(i))) {
+        uses_[operand.unwarp()]++;
+      }
+    }
+  }
+
+  void run() {
+    for (size_t i = 0; i < source_->ops_size(); i++) {
+      values_.push_back(source_->visit(
+          OpHandle(i), [&](OpHandle handle, auto &&op) -> Lazy {
+            return (*this)(handle, op);
+          }));
+    }
+  }
+
+  // Everything that is not linear in its secret operands needs them exact.
+  template <class T> auto operator()(OpHandle handle, const T &) -> Lazy {
+    return exact(handle);
+  }
+
+  auto operator()(OpHandle handle, const TruncateAOp &op) -> Lazy {
+    auto operand = value(op.operand);
+    auto result = operand.handle;
+    uint8_t shift = operand.shift + op.bits;
+    bool keeps_fixed_point =
+        op.type.fixed_point == source_->type(op.operand).fixed_point;
+
+    if (is_fused_product(op.operand)) {
+      if (!keeps_fixed_point) {
+        return {builder_.truncate_a(result, shift), 0};
+      } else if (operand.shift == 0) {
+        return {builder_.divide_pow_of_2(result, op.bits), 0};
+      }
+    }
+    // divide_pow_of_2: relabel the operand so that the fixed point of the
+    // result is still the one of the source plus `shift`
+    if (keeps_fixed_point) {
+      if (!fits(handle, shift)) {
+        return exact(handle);
+      }
+      result = builder_.multiply_ap(result, scalar(result, 1, op.bits));
+    }
+    return {result, shift};
+  }
+
+  auto operator()(OpHandle, const NegateAOp &op) -> Lazy {
+    auto operand = value(op.operand);
+    return {builder_.negate_a(operand.handle), operand.shift};
+  }
+
+  auto operator()(OpHandle, const BroadcastOp &op) -> Lazy {
+    auto operand = value(op.operand);
+    auto result = builder_.broadcast(operand.handle, copy(op.dimensions),
+                                     shape(op.type.shape));
+    return {result, operand.shift};
+  }
+
+  auto operator()(OpHandle, const ReshapeOp &op) -> Lazy {
+    auto operand = value(op.operand);
+    auto result = builder_.reshape(operand.handle, shape(op.type.shape));
+    return {result, operand.shift};
+  }
+
+  auto operator()(OpHandle, const SliceOp &op) -> Lazy {
+    auto operand = value(op.operand);
+    auto result = builder_.slice(operand.handle, copy(op.start), copy(op.end),
+                                 copy(op.stride));
+    return {result, operand.shift};
+  }
+
+  // the indices are needed exact, the gathered rows keep their shift
+  auto operator()(OpHandle, const GatherOp &op) -> Lazy {
+    auto operand = value(op.left);
+    auto result =
+        builder_.gather(operand.handle, materialize(op.right), op.size);
+    return {result, operand.shift};
+  }
+
+  auto operator()(OpHandle, const TransposeOp &op) -> Lazy {
+    auto operand = value(op.operand);
+    auto result = builder_.transpose(operand.handle, copy(op.permutation));
+    return {result, operand.shift};
+  }
+
+  auto operator()(OpHandle, const ReduceSumOp &op) -> Lazy {
+    auto operand = value(op.operand);
+    auto result = builder_.reduce_sum(operand.handle, copy(op.dimensions));
+    return {result, operand.shift};
+  }
+
+  auto operator()(OpHandle handle, const ConcateOp &op) -> Lazy {
+    uint8_t shift = 0;
+    for (auto operand : op.operands) {
+      shift = std::max(shift, value(operand).shift);
+    }
+    if (!fits(handle, shift)) {
+      return exact(handle);
+    }
+    std::vector<OpHandle> operands;
+    for (auto operand : op.operands) {
+      operands.push_back(widen(value(operand), shift));
+    }
+    auto result = builder_.concate(std::move(operands), op.dimension);
+    return {result, shift};
+  }
+
+  auto operator()(OpHandle handle, const AddAAOp &op) -> Lazy {
+    auto left = value(op.left);
+    auto right = value(op.right);
+    uint8_t shift = std::max(left.shift, right.shift);
+    if (!fits(handle, shift)) {
+      return exact(handle);
+    }
+    auto result =
+        builder_.add_aa(widen(left, shift), widen(right, shift));
+    return {result, shift};
+  }
+
+  auto operator()(OpHandle handle, const AddAPOp &op) -> Lazy {
+    auto left = value(op.left);
+    auto right = value(op.right);
+    if (!fits(handle, left.shift)) {
+      return exact(handle);
+    }
+    auto result = builder_.add_ap(left.handle, widen(right, left.shift));
+    return {result, left.shift};
+  }
+
+  auto operator()(OpHandle handle, const MultiplyAPOp &op) -> Lazy {
+    return product(handle, op, &ABPBuilder::multiply_ap);
+  }
+
+  auto operator()(OpHandle handle, const DotGeneralAPOp &op) -> Lazy {
+    auto build = [&](ABPBuilder &builder, OpHandle left, OpHandle right) {
+      return builder.dot_general_ap(left, right, op.transpose_left,
+                                    op.transpose_right);
+    };
+    return product(handle, op, build);
+  }
+
+  auto operator()(OpHandle handle, const MultiplyAAOp &op) -> Lazy {
+    return product(handle, op, &ABPBuilder::multiply_aa);
+  }
+
+  auto operator()(OpHandle handle, const DotGeneralAAOp &op) -> Lazy {
+    auto build = [&](ABPBuilder &builder, OpHandle left, OpHandle right) {
+      return builder.dot_general_aa(left, right, op.transpose_left,
+                                    op.transpose_right);
+    };
+    return product(handle, op, build);
+  }
+
+  auto operator()(OpHandle handle, const DotProductAAOp &op) -> Lazy {
+    return product(handle, op, &ABPBuilder::dot_product_aa);
+  }
+
+private:
+  // the source op on exact operands, also used when a deferred truncation
+  // would not fit
+  auto exact(OpHandle handle) -> Lazy {
+    std::vector<OpHandle> operands;
+    for (auto operand : source_->operands(handle)) {
+      operands.push_back(materialize(operand));
+    }
+    auto result = builder_.clone(*source_, handle, std::move(operands));
+    return {result, 0};
+  }
+
+  // The shifts of both operands add up.
+  template <class T, class Build>
+  auto product(OpHandle handle, const T &op, Build build) -> Lazy {
+    auto left = value(op.left);
+    auto right = value(op.right);
+    uint8_t shift = left.shift + right.shift;
+    if (!fits(handle, shift)) {
+      return exact(handle);
+    }
+    auto result = std::invoke(build, builder_, left.handle, right.handle);
+    return {result, shift};
+  }
+
+  auto value(OpHandle operand) const -> const Lazy & {
+    return values_[operand.unwarp()];
+  }
+
+  // The exact value of `operand`, deferred truncations are merged into one.
+  auto materialize(OpHandle operand) -> OpHandle {
+    auto &lazy = value(operand);
+    if (lazy.shift == 0) {
+      return lazy.handle;
+    }
+    return builder_.truncate_a(lazy.handle, lazy.shift);
+  }
+
+  // `lazy` raised to `shift`, multiplying by a power of two is local
+  auto widen(const Lazy &lazy, uint8_t shift) -> OpHandle {
+    assert(shift >= lazy.shift);
+    uint8_t bits = shift - lazy.shift;
+    if (bits == 0) {
+      return lazy.handle;
+    }
+    auto factor = scalar(lazy.handle, uint64_t{1} << bits, bits);
+    auto &context = builder_.context();
+    if (context.type(lazy.handle).kind == TypeKind::kArithFixed64) {
+      return builder_.multiply_ap(lazy.handle, factor);
+    }
+    return builder_.multiply_pp(lazy.handle, factor);
+  }
+
+  // public `raw` at `fixed_point`, in the shape of `like`
+  auto scalar(OpHandle like, uint64_t raw, uint8_t fixed_point) -> OpHandle {
+    auto &context = builder_.context();
+    Type type{
+        .kind = TypeKind::kFixed64,
+        .fixed_point = fixed_point,
+        .shape = builder_.push(Shape{}),
+    };
+    DenseValue dense_value(1);
+    dense_value[0] = raw;
+    auto result = builder_.constant(builder_.push(std::move(dense_value)), type);
+    auto shape = context.type(like).shape;
+    if (!context.shape(shape).empty()) {
+      result = builder_.broadcast(result, {}, shape);
+    }
+    return result;
+  }
+
+  // The value of `handle` at `shift` more fractional bits, bounded by the
+  // range of the source op, stays below the truncation mask.
+  auto fits(OpHandle handle, uint8_t shift) const -> bool {
+    auto type = source_->type(handle);
+    auto width = signed_width(source_->range(handle), type.fixed_point + shift);
+    return width + kMaskHeadroom <= 64;
+  }
+
+  auto is_fused_product(OpHandle handle) const -> bool {
+    if (uses_[handle.unwarp()] != 1) {
+      return false;
+    }
+    return source_->visit(handle, [](OpHandle, auto &&op) {
+      using T = std::decay_t<decltype(op)>;
+      return std::is_same_v<T, MultiplyAAOp> ||
+             std::is_same_v<T, DotGeneralAAOp> ||
+             std::is_same_v<T, DotProductAAOp>;
+    });
+  }
+
+  auto copy(DenseSizeTHandle handle) const -> DenseSizeT {
+    return DenseSizeT(source_->dense_size_t(handle));
+  }
+
+  auto shape(ShapeHandle handle) -> ShapeHandle {
+    return builder_.push(Shape(source_->shape(handle)));
+  }
+
+  const ABPContext *source_;
+  ABPBuilder builder_;
+  std::vector<size_t> uses_;
+  std::vector<Lazy> values_;
+};
+
+} // namespace
+
+auto sink_truncations(const ABPContext &source) -> ABPContext {
+  ABPContext result;
+  TruncationSinking pass(source, result);
+  pass.run();
+  return result;
+}
+
+} // namespace fastmpc::abp
\ No newline at end of file
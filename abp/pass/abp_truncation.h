@@ -0,0 +1,16 @@
+#pragma once
+
+#include "fastmpc/abp/dialect/abp_context.h"
+
+namespace fastmpc::abp {
+
+// Rewrites `source` so that truncations of secret values are deferred through
+// linear ops and products and merged, a sum of products is truncated once
+// where its value is used. Truncations the ABY3 lowering fuses into the
+// product they follow are kept in place.
+//
+// A truncation is only deferred while the range of the wider value fits below
+// the truncation mask, values of unknown range are truncated where they are.
+auto sink_truncations(const ABPContext &source) -> ABPContext;
+
+} // namespace fastmpc::abp
\ No newline at end of file
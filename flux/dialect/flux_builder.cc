@@ -1,5 +1,6 @@
 #include "fastmpc/flux/dialect/flux_builder.h"
 
+#include <algorithm>
 #include <cassert>
 #include <functional>
 #include <numeric>
@@ -32,6 +33,7 @@ DECL_PUSH(ReshapeOp, reshape_ops_)
 DECL_PUSH(ShiftLeftOp, shift_left_ops_)
 DECL_PUSH(SliceOp, slice_ops_)
 DECL_PUSH(TransposeOp, transpose_ops_)
+DECL_PUSH(ReduceSumOp, reduce_sum_ops_)
 DECL_PUSH(AddOp, add_ops_)
 DECL_PUSH(AndOp, and_ops_)
 DECL_PUSH(BitReverseOp, bit_reverse_ops_)
@@ -39,6 +41,7 @@ DECL_PUSH(MatmulOp, matmul_ops_)
 DECL_PUSH(MultiplyOp, multiply_ops_)
 DECL_PUSH(SubtractOp, subtract_ops_)
 DECL_PUSH(XorOp, xor_ops_)
+DECL_PUSH(GatherOp, gather_ops_)
 DECL_PUSH(ConstantOp, constant_ops_)
 DECL_PUSH(RandomOp, random_ops_)
 DECL_PUSH(ConcateOp, concate_ops_)
@@ -206,6 +209,27 @@ auto FluxBuilder::transpose(OpHandle operand, DenseSizeTHandle handle)
   });
 }
 
+auto FluxBuilder::reduce_sum(OpHandle operand, DenseSizeTHandle handle)
+    -> OpHandle {
+  auto &dimensions = inner_->dense_size_t(handle);
+  auto type = inner_->type(operand);
+  auto &in_shape = inner_->shape(operand);
+  Shape out_shape;
+  for (size_t i = 0; i < in_shape.size(); i++) {
+    if (std::find(dimensions.begin(), dimensions.end(), i) ==
+        dimensions.end()) {
+      out_shape.push_back(in_shape[i]);
+    }
+  }
+  assert(out_shape.size() + dimensions.size() == in_shape.size());
+  type.shape = push(std::move(out_shape));
+  return push_op(ReduceSumOp{
+      .type = type,
+      .operand = operand,
+      .dimensions = handle,
+  });
+}
+
 auto FluxBuilder::add(OpHandle left, OpHandle right) -> OpHandle {
   assert(check_holder(left, right) && check_shape(left, right));
   return push_op(AddOp{
@@ -224,18 +248,32 @@ auto FluxBuilder::_and(OpHandle left, OpHandle right) -> OpHandle {
   });
 }
 
-auto FluxBuilder::matmul(OpHandle left, OpHandle right) -> OpHandle {
+auto FluxBuilder::matmul(OpHandle left, OpHandle right, bool transpose_left,
+                         bool transpose_right) -> OpHandle {
   assert(check_holder(left, right));
   auto left_shape = inner_->shape(left);
   auto right_shape = inner_->shape(right);
-  assert(left_shape.size() == 2 && right_shape.size() == 2);
-  assert(left_shape[1] == right_shape[0]);
+  // [batch..., m, k] x [batch..., k, n] = [batch..., m, n]
+  size_t rank = left_shape.size();
+  assert(rank >= 2 && right_shape.size() == rank);
+  assert(std::equal(left_shape.begin(), left_shape.end() - 2,
+                    right_shape.begin()));
+  if (transpose_left) {
+    std::swap(left_shape[rank - 2], left_shape[rank - 1]);
+  }
+  if (transpose_right) {
+    std::swap(right_shape[rank - 2], right_shape[rank - 1]);
+  }
+  assert(left_shape[rank - 1] == right_shape[rank - 2]);
   auto type = inner_->type(left);
-  type.shape = push(Shape{left_shape[0], right_shape[1]});
+  left_shape[rank - 1] = right_shape[rank - 1];
+  type.shape = push(std::move(left_shape));
   return push_op(MatmulOp{
       .type = type,
       .left = left,
       .right = right,
+      .transpose_left = transpose_left,
+      .transpose_right = transpose_right,
   });
 }
 
@@ -266,6 +304,25 @@ auto FluxBuilder::_xor(OpHandle left, OpHandle right) -> OpHandle {
   });
 }
 
+auto FluxBuilder::gather(OpHandle operand, OpHandle indices, size_t size)
+    -> OpHandle {
+  assert(check_holder(operand, indices));
+  auto type = inner_->type(operand);
+  auto &in_shape = inner_->shape(operand);
+  assert(!in_shape.empty() && size <= in_shape[0]);
+  // [indices..., size, operand[1:]...]
+  Shape shape = inner_->shape(indices);
+  shape.push_back(size);
+  shape.insert(shape.end(), in_shape.begin() + 1, in_shape.end());
+  type.shape = push(std::move(shape));
+  return push_op(GatherOp{
+      .type = type,
+      .left = operand,
+      .right = indices,
+      .size = size,
+  });
+}
+
 auto FluxBuilder::constant(DenseValueHandle value, Type type) -> OpHandle {
   return push_op(ConstantOp{
       .type = type,
@@ -35,12 +35,17 @@ public:
   auto slice(OpHandle operand, DenseSizeTHandle start, DenseSizeTHandle end,
              DenseSizeTHandle strides) -> OpHandle;
   auto transpose(OpHandle opearnd, DenseSizeTHandle permutation) -> OpHandle;
+  auto reduce_sum(OpHandle operand, DenseSizeTHandle dimensions) -> OpHandle;
   auto add(OpHandle left, OpHandle right) -> OpHandle;
   auto _and(OpHandle left, OpHandle right) -> OpHandle;
-  auto matmul(OpHandle left, OpHandle right) -> OpHandle;
+  // a flagged operand is read with its last two dimensions swapped
+  auto matmul(OpHandle left, OpHandle right, bool transpose_left = false,
+              bool transpose_right = false) -> OpHandle;
   auto multiply(OpHandle left, OpHandle right) -> OpHandle;
   auto subtract(OpHandle left, OpHandle right) -> OpHandle;
   auto _xor(OpHandle left, OpHandle right) -> OpHandle;
+  // `size` rows of `operand` from every integer index, both on one party
+  auto gather(OpHandle operand, OpHandle indices, size_t size = 1) -> OpHandle;
   auto constant(DenseValueHandle value, Type type) -> OpHandle;
   auto constant(DenseValue &&value, Type type) -> OpHandle;
   auto random(size_t p0, size_t p1, ShapeHandle shape)
@@ -65,6 +65,8 @@ public:
       return func(handle, slice_ops_[op.offset]);
     case OpKind::kTransposeOp:
       return func(handle, transpose_ops_[op.offset]);
+    case OpKind::kReduceSumOp:
+      return func(handle, reduce_sum_ops_[op.offset]);
     case OpKind::kAddOp:
       return func(handle, add_ops_[op.offset]);
     case OpKind::kAndOp:
@@ -77,6 +79,8 @@ public:
       return func(handle, subtract_ops_[op.offset]);
     case OpKind::kXorOp:
       return func(handle, xor_ops_[op.offset]);
+    case OpKind::kGatherOp:
+      return func(handle, gather_ops_[op.offset]);
     case OpKind::kConstantOp:
       return func(handle, constant_ops_[op.offset]);
     case OpKind::kRandomOp:
@@ -110,6 +114,7 @@ private:
   std::vector<ShiftLeftOp> shift_left_ops_;
   std::vector<SliceOp> slice_ops_;
   std::vector<TransposeOp> transpose_ops_;
+  std::vector<ReduceSumOp> reduce_sum_ops_;
   std::vector<AddOp> add_ops_;
   std::vector<AndOp> and_ops_;
   std::vector<BitReverseOp> bit_reverse_ops_;
@@ -117,6 +122,7 @@ private:
   std::vector<MultiplyOp> multiply_ops_;
   std::vector<SubtractOp> subtract_ops_;
   std::vector<XorOp> xor_ops_;
+  std::vector<GatherOp> gather_ops_;
   std::vector<ConstantOp> constant_ops_;
   std::vector<RandomOp> random_ops_;
   std::vector<ConcateOp> concate_ops_;
@@ -61,12 +61,43 @@ void OutputOp::print(std::ostream &out, const FluxContext &context) const {
   }
 DEF_BINARY_OP(AddOp, add)
 DEF_BINARY_OP(AndOp, and);
-DEF_BINARY_OP(MatmulOp, matmul)
 DEF_BINARY_OP(MultiplyOp, multiply)
 DEF_BINARY_OP(SubtractOp, subtract)
 DEF_BINARY_OP(XorOp, xor)
 #undef DEF_BINARY_OP
 
+void GatherOp::print(std::ostream &out, const FluxContext &context) const {
+  out << "gather ";
+  left.print(out);
+  out << ", ";
+  right.print(out);
+  out << ", ";
+  print_attr(out, "size", size);
+  out << ": (";
+  context.type(left).print(out, context);
+  out << ", ";
+  context.type(right).print(out, context);
+  out << ") -> ";
+  type.print(out, context);
+}
+
+void MatmulOp::print(std::ostream &out, const FluxContext &context) const {
+  out << "matmul ";
+  left.print(out);
+  out << ", ";
+  right.print(out);
+  out << ", ";
+  print_attr(out, "transpose_left", static_cast<size_t>(transpose_left));
+  out << ", ";
+  print_attr(out, "transpose_right", static_cast<size_t>(transpose_right));
+  out << ": (";
+  context.type(left).print(out, context);
+  out << ", ";
+  context.type(right).print(out, context);
+  out << ") -> ";
+  type.print(out, context);
+}
+
 #define DEF_UNARY_OP(OpName, Name)                                             \
   void OpName::print(std::ostream &out, const FluxContext &context) const {    \
     out << #Name " ";                                                          \
@@ -109,6 +140,7 @@ DEF_UNARY_OP(BroadcastOp, broadcast, dimensions)
 DEF_UNARY_OP(InverseOp, inverse, fixed_point)
 DEF_UNARY_OP(LShiftRightOp, logic_shift_right, bits)
 DEF_UNARY_OP(TransposeOp, transpose, permutation)
+DEF_UNARY_OP(ReduceSumOp, reduce_sum, dimensions)
 DEF_UNARY_OP(ShiftLeftOp, shift_left, bits)
 #undef DEF_UNARY_OP
 
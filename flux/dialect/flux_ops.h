@@ -23,6 +23,7 @@ enum class OpKind {
   kShiftLeftOp,
   kSliceOp,
   kTransposeOp,
+  kReduceSumOp,
 
   kAddOp,
   kAndOp,
@@ -30,6 +31,7 @@ enum class OpKind {
   kMultiplyOp,
   kSubtractOp,
   kXorOp,
+  kGatherOp,
 
   kConstantOp,
   kRandomOp,
@@ -86,10 +88,16 @@ struct OutputOp {
 
 DECL_BINARY_OP(AddOp);
 DECL_BINARY_OP(AndOp);
-DECL_BINARY_OP(MatmulOp);
+// Matrix products of the last two dimensions, a flagged operand is read with
+// those two dimensions swapped.
+DECL_BINARY_OP(MatmulOp, bool transpose_left; bool transpose_right;);
 DECL_BINARY_OP(MultiplyOp);
 DECL_BINARY_OP(SubtractOp);
 DECL_BINARY_OP(XorOp);
+// Slices of `size` rows of left along its first dimension, one from every
+// integer index in right, clamped to stay in bounds. The result is
+// [right shape..., size, left shape[1:]...].
+DECL_BINARY_OP(GatherOp, size_t size;);
 #undef DECL_BINARY_OP
 
 #define DECL_UNARY_OP(OpName, ...)                                             \
@@ -115,6 +123,7 @@ DECL_UNARY_OP(ShiftLeftOp, uint8_t bits;);
 DECL_UNARY_OP(SliceOp, DenseSizeTHandle start; DenseSizeTHandle end;
               DenseSizeTHandle stride;);
 DECL_UNARY_OP(TransposeOp, DenseSizeTHandle permutation;);
+DECL_UNARY_OP(ReduceSumOp, DenseSizeTHandle dimensions;);
 #undef DECL_UNARY_OP
 
 struct RandomOp {
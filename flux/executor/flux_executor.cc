@@ -1,5 +1,6 @@
 #include "fastmpc/flux/executor/flux_executor.h"
 
+#include "fastmpc/abp/executor/abp_kernels.h"
 #include "fastmpc/eager/tensor.h"
 #include "fastmpc/eager/tensor_ops.h"
 #include "fastmpc/flux/dialect/flux_context.h"
@@ -116,6 +117,13 @@ void FluxExecutor::operator()(OpHandle handle, SliceOp op) {
   push(handle, operand.slice(start, end, hacked));
 }
 
+void FluxExecutor::operator()(OpHandle handle, ReduceSumOp op) {
+  auto operand = get(op.operand);
+  auto &dimensions = context_->dense_size_t(op.dimensions);
+  auto &shape = context_->shape(op.type.shape);
+  push(handle, abp::reduce_sum(operand, dimensions, shape));
+}
+
 void FluxExecutor::operator()(OpHandle handle, TransposeOp op) {
   auto operand = get(op.operand);
   auto &permutation = context_->dense_size_t(op.permutation);
@@ -137,7 +145,8 @@ void FluxExecutor::operator()(OpHandle handle, AndOp op) {
 void FluxExecutor::operator()(OpHandle handle, MatmulOp op) {
   auto x = get(op.left);
   auto y = get(op.right);
-  push(handle, eager::matmul(x, y));
+  push(handle,
+       abp::batch_matmul(x, y, op.transpose_left, op.transpose_right));
 }
 
 void FluxExecutor::operator()(OpHandle handle, MultiplyOp op) {
@@ -158,6 +167,14 @@ void FluxExecutor::operator()(OpHandle handle, XorOp op) {
   push(handle, eager::_xor(x, y));
 }
 
+void FluxExecutor::operator()(OpHandle handle, GatherOp op) {
+  auto table = get(op.left);
+  auto indices = get(op.right);
+  auto &shape = context_->shape(op.type.shape);
+  // the indices are integers
+  push(handle, abp::gather(table, indices, 0, op.size, shape));
+}
+
 void FluxExecutor::operator()(OpHandle handle, ConstantOp op) {
   auto result = eager::Tensor(context_->shape(op.type.shape));
   auto &value = context_->dense_value(op.value).as_vector();
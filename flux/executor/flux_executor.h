@@ -41,12 +41,14 @@ public:
   void operator()(OpHandle handle, ShiftLeftOp op);
   void operator()(OpHandle handle, SliceOp op);
   void operator()(OpHandle handle, TransposeOp op);
+  void operator()(OpHandle handle, ReduceSumOp op);
   void operator()(OpHandle handle, AddOp op);
   void operator()(OpHandle handle, AndOp op);
   void operator()(OpHandle handle, MatmulOp op);
   void operator()(OpHandle handle, MultiplyOp op);
   void operator()(OpHandle handle, SubtractOp op);
   void operator()(OpHandle handle, XorOp op);
+  void operator()(OpHandle handle, GatherOp op);
   void operator()(OpHandle handle, ConstantOp op);
   void operator()(OpHandle handle, RandomOp op);
   void operator()(OpHandle handle, ConcateOp op);
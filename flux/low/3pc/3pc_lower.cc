@@ -208,6 +208,20 @@ namespace fastmpc::flux::_3pc {
         set_value(handle, result);
     }
 
+    void _3PCLower::operator()(abp::OpHandle handle, abp::DotGeneralAPOp op) {
+        if (abp_context_->type(op.left).kind == abp::TypeKind::kFixed64) {
+            auto left   = get_plain_value(op.left);
+            auto right  = get_cipher_value(op.right);
+            auto result = matmul_pa(*builder_, left, right, op.transpose_left, op.transpose_right);
+            set_value(handle, result);
+            return;
+        }
+        auto left   = get_cipher_value(op.left);
+        auto right  = get_plain_value(op.right);
+        auto result = matmul_ap(*builder_, left, right, op.transpose_left, op.transpose_right);
+        set_value(handle, result);
+    }
+
     void _3PCLower::operator()(abp::OpHandle handle, abp::BroadcastOp op) {
         auto dimensions = abp_context_->dense_size_t(op.dimensions);
         auto shape      = abp_context_->shape(handle);
@@ -290,6 +304,39 @@ namespace fastmpc::flux::_3pc {
         visit_value(op.operand, visitor);
     }
 
+    // The indices are brought to integers first, then every party gathers
+    // the rows of its own values.
+    void _3PCLower::operator()(abp::OpHandle handle, abp::GatherOp op) {
+        auto indices     = get_plain_value(op.right);
+        auto fixed_point = abp_context_->type(op.right).fixed_point;
+        if (fixed_point != 0) {
+            indices = truncate_p(*builder_, indices, fixed_point);
+        }
+
+        struct Visitor: public ValueVisitor {
+            Visitor(_3PCLower *lower, abp::OpHandle handle, PlainValue indices, size_t size):
+                lower(lower), handle(handle), indices(indices), size(size) {}
+
+            void visit(PlainValue operand) override {
+                auto result = gather(*lower->builder_, operand, indices, size);
+                lower->set_value(handle, result);
+            }
+
+            void visit(CipherValue operand) override {
+                auto result = gather(*lower->builder_, operand, indices, size);
+                lower->set_value(handle, result);
+            }
+
+            _3PCLower *lower;
+            abp::OpHandle handle;
+            PlainValue indices;
+            size_t size;
+        };
+
+        Visitor visitor(this, handle, indices, op.size);
+        visit_value(op.left, visitor);
+    }
+
     void _3PCLower::operator()(abp::OpHandle handle, abp::TransposeOp op) {
         auto permutation = abp_context_->dense_size_t(op.permutation);
         struct Visitor : public ValueVisitor {
@@ -315,6 +362,31 @@ namespace fastmpc::flux::_3pc {
         visit_value(op.operand, visitor);
     }
 
+    void _3PCLower::operator()(abp::OpHandle handle, abp::ReduceSumOp op) {
+        auto dimensions = abp_context_->dense_size_t(op.dimensions);
+        struct Visitor : public ValueVisitor {
+            Visitor(_3PCLower *lower, abp::OpHandle handle, DenseSizeT &&dimensions): 
+                lower(lower), handle(handle), dimensions(~dimensions) {}
+
+            void visit(PlainValue operand) override {
+                auto result = reduce_sum(*lower->builder_, operand, ~dimensions);
+                lower->set_value(handle, result);
+            }
+
+            void visit(CipherValue operand) override {
+                auto result = reduce_sum(*lower->builder_, operand, ~dimensions);
+                lower->set_value(handle, result);
+            }
+
+            _3PCLower *lower;
+            abp::OpHandle handle;
+            DenseSizeT dimensions;
+        };
+
+        Visitor visitor(this, handle, ~dimensions);
+        visit_value(op.operand, visitor);
+    }
+
     void _3PCLower::operator()(abp::OpHandle handle, abp::ConcateOp op) {
         if (abp_context_->type(handle).kind == abp::TypeKind::kFixed64) {
             vector <PlainValue> plain_values;
@@ -34,6 +34,7 @@ namespace fastmpc::flux::_3pc {
             void operator()(abp::OpHandle handle, abp::MultiplyAAOp op);
             void operator()(abp::OpHandle handle, abp::MultiplyAPOp op);
             void operator()(abp::OpHandle handle, abp::MultiplyPPOp op);
+            void operator()(abp::OpHandle handle, abp::DotGeneralAPOp op);
             
             void operator()(abp::OpHandle handle, abp::ConstantOp op);
             void operator()(abp::OpHandle handle, abp::NegateAOp op);
@@ -54,7 +55,9 @@ namespace fastmpc::flux::_3pc {
             void operator()(abp::OpHandle handle, abp::BroadcastOp op);
             void operator()(abp::OpHandle handle, abp::ReshapeOp   op);
             void operator()(abp::OpHandle handle, abp::SliceOp     op);
+            void operator()(abp::OpHandle handle, abp::GatherOp    op);
             void operator()(abp::OpHandle handle, abp::TransposeOp op);
+            void operator()(abp::OpHandle handle, abp::ReduceSumOp op);
             void operator()(abp::OpHandle handle, abp::ConcateOp   op);
 
         private:
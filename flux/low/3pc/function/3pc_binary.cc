@@ -78,6 +78,49 @@ namespace fastmpc::flux::_3pc {
         };
     }
 
+    // A public right operand distributes over the shares, so every party
+    // multiplies its own shares locally and no resharing is needed.
+    auto matmul_ap(FluxBuilder &builder, CipherValue x, PlainValue y,
+                   bool transpose_x, bool transpose_y) -> CipherValue {
+        auto [p0_x0, p0_x1, p1_x1, p1_x2, p2_x2, p2_x0] = x;
+        auto [p0_y, p1_y, p2_y] = y;
+        auto matmul = [&](OpHandle share, OpHandle plain) {
+            return builder.matmul(share, plain, transpose_x, transpose_y);
+        };
+
+        return CipherValue{
+            .p0_v0 = matmul(p0_x0, p0_y),
+            .p0_v1 = matmul(p0_x1, p0_y),
+
+            .p1_v1 = matmul(p1_x1, p1_y),
+            .p1_v2 = matmul(p1_x2, p1_y),
+
+            .p2_v2 = matmul(p2_x2, p2_y),
+            .p2_v0 = matmul(p2_x0, p2_y),
+        };
+    }
+
+    // the same with the public operand on the left
+    auto matmul_pa(FluxBuilder &builder, PlainValue x, CipherValue y,
+                   bool transpose_x, bool transpose_y) -> CipherValue {
+        auto [p0_x, p1_x, p2_x] = x;
+        auto [p0_y0, p0_y1, p1_y1, p1_y2, p2_y2, p2_y0] = y;
+        auto matmul = [&](OpHandle plain, OpHandle share) {
+            return builder.matmul(plain, share, transpose_x, transpose_y);
+        };
+
+        return CipherValue{
+            .p0_v0 = matmul(p0_x, p0_y0),
+            .p0_v1 = matmul(p0_x, p0_y1),
+
+            .p1_v1 = matmul(p1_x, p1_y1),
+            .p1_v2 = matmul(p1_x, p1_y2),
+
+            .p2_v2 = matmul(p2_x, p2_y2),
+            .p2_v0 = matmul(p2_x, p2_y0),
+        };
+    }
+
     auto multiply_pp(FluxBuilder &builder, PlainValue x, PlainValue y) -> PlainValue {
         auto [p0_x, p1_x, p2_x] = x;
         auto [p0_y, p1_y, p2_y] = y;
@@ -12,4 +12,10 @@ namespace fastmpc::flux::_3pc {
     auto multiply_ap(FluxBuilder &builder, CipherValue x, PlainValue  y) -> CipherValue;
     auto multiply_pp(FluxBuilder &builder,  PlainValue x, PlainValue  y) -> PlainValue;
 
+    // a flagged operand is read with its last two dimensions swapped
+    auto matmul_ap(FluxBuilder &builder, CipherValue x, PlainValue y,
+                   bool transpose_x = false, bool transpose_y = false) -> CipherValue;
+    auto matmul_pa(FluxBuilder &builder, PlainValue x, CipherValue y,
+                   bool transpose_x = false, bool transpose_y = false) -> CipherValue;
+
 }
\ No newline at end of file
@@ -132,6 +132,33 @@ TEST_F(_3PCFunctionTest, multiply_ap) {
   }
 }
 
+TEST_F(_3PCFunctionTest, matmul_ap) {
+  auto a = input_secret(0, make_tensor({114, 514}).reshape({2, 1}));
+  auto p = input_public(1, make_tensor({1919, 810}).reshape({1, 2}));
+  auto result = matmul_ap(builder, a, p);
+  output(builder, 0, result);
+  executor.run();
+  {
+    auto result = output_secret(0);
+    EXPECT_EQ(result.at({0, 0}), 114 * 1919);
+    EXPECT_EQ(result.at({0, 1}), 114 * 810);
+    EXPECT_EQ(result.at({1, 0}), 514 * 1919);
+    EXPECT_EQ(result.at({1, 1}), 514 * 810);
+  }
+}
+
+TEST_F(_3PCFunctionTest, reduce_sum) {
+  auto a = input_secret(0, make_tensor({114, 514, 1919, 810}).reshape({2, 2}));
+  auto result = reduce_sum(builder, a, {1});
+  output(builder, 0, result);
+  executor.run();
+  {
+    auto result = output_secret(0);
+    EXPECT_EQ(result.at({0}), 114 + 514);
+    EXPECT_EQ(result.at({1}), 1919 + 810);
+  }
+}
+
 TEST_F(_3PCFunctionTest, multiply_pp) {
   auto x = input_public(0, make_tensor({114, 514}));
   auto y = input_public(1, make_tensor({1919, 810}));
@@ -221,6 +221,31 @@ namespace fastmpc::flux::_3pc {
         });
     }
 
+    auto gather(FluxBuilder &builder, CipherValue operand, PlainValue indices, size_t size) -> CipherValue {
+        auto [p0_v0, p0_v1, p1_v1, p1_v2, p2_v2, p2_v0] = operand;
+        auto [p0_i, p1_i, p2_i] = indices;
+        return CipherValue{
+            .p0_v0 = builder.gather(p0_v0, p0_i, size),
+            .p0_v1 = builder.gather(p0_v1, p0_i, size),
+
+            .p1_v1 = builder.gather(p1_v1, p1_i, size),
+            .p1_v2 = builder.gather(p1_v2, p1_i, size),
+
+            .p2_v2 = builder.gather(p2_v2, p2_i, size),
+            .p2_v0 = builder.gather(p2_v0, p2_i, size),
+        };
+    }
+
+    auto gather(FluxBuilder &builder, PlainValue operand, PlainValue indices, size_t size) -> PlainValue {
+        auto [p0_v, p1_v, p2_v] = operand;
+        auto [p0_i, p1_i, p2_i] = indices;
+        return PlainValue{
+            .p0_v = builder.gather(p0_v, p0_i, size),
+            .p1_v = builder.gather(p1_v, p1_i, size),
+            .p2_v = builder.gather(p2_v, p2_i, size),
+        };
+    }
+
     auto transpose(FluxBuilder &builder, CipherValue operand, DenseSizeT &&permutation) -> CipherValue {
         return apply(operand, [&builder, permutation = builder.push(~permutation)](OpHandle op) { 
             return builder.transpose(op, permutation); 
@@ -233,6 +258,19 @@ namespace fastmpc::flux::_3pc {
         });
     }
 
+    // Additive shares are summed locally, share by share.
+    auto reduce_sum(FluxBuilder &builder, CipherValue operand, DenseSizeT &&dimensions) -> CipherValue {
+        return apply(operand, [&builder, dimensions = builder.push(~dimensions)](OpHandle op) {
+            return builder.reduce_sum(op, dimensions);
+        });
+    }
+
+    auto reduce_sum(FluxBuilder &builder, PlainValue operand, DenseSizeT &&dimensions) -> PlainValue {
+        return apply(operand, [&builder, dimensions = builder.push(~dimensions)](OpHandle op) {
+            return builder.reduce_sum(op, dimensions);
+        });
+    }
+
     auto concat(FluxBuilder &builder, vector<PlainValue> &operands, size_t dimension) -> PlainValue {
         auto func = [&](OpHandle PlainValue::*p) {
             vector <OpHandle> ops;
@@ -31,8 +31,16 @@ namespace fastmpc::flux::_3pc {
     auto slice(FluxBuilder &builder, CipherValue operand, DenseSizeT &&start, DenseSizeT &&end, DenseSizeT &&stride) -> CipherValue;
     auto slice(FluxBuilder &builder, PlainValue  operand, DenseSizeT &&start, DenseSizeT &&end, DenseSizeT &&stride) -> PlainValue;
     
+    // Every party copies the rows of its own shares at its copy of the public
+    // integer indices, no communication.
+    auto gather(FluxBuilder &builder, CipherValue operand, PlainValue indices, size_t size) -> CipherValue;
+    auto gather(FluxBuilder &builder, PlainValue  operand, PlainValue indices, size_t size) -> PlainValue;
+    
     auto transpose(FluxBuilder &builder, CipherValue operand, DenseSizeT &&permutation) -> CipherValue;
     auto transpose(FluxBuilder &builder, PlainValue  operand, DenseSizeT &&permutation) -> PlainValue;
+
+    auto reduce_sum(FluxBuilder &builder, CipherValue operand, DenseSizeT &&dimensions) -> CipherValue;
+    auto reduce_sum(FluxBuilder &builder, PlainValue  operand, DenseSizeT &&dimensions) -> PlainValue;
     
     auto concat(FluxBuilder &builder, vector <PlainValue>  &operands, size_t dimension) -> PlainValue;
     auto concat(FluxBuilder &builder, vector <CipherValue> &operands, size_t dimension) -> CipherValue;
@@ -1,6 +1,8 @@
 #include "fastmpc/flux/low/aby3/aby3_lower.h"
 
 #include <cassert>
+#include <cstdlib>
+#include <type_traits>
 
 #include "fastmpc/abp/dialect/abp_ops.h"
 #include "fastmpc/abp/dialect/abp_types.h"
@@ -35,12 +37,68 @@ void ABY3Lower::visit_value(abp::OpHandle handle, _3pc::ValueVisitor &visitor) {
 }
 
 void ABY3Lower::run() {
+  collect_fused_products();
   for (size_t i = 0; i < abp_context_->ops_size(); i++) {
     abp::OpHandle handle(i);
     abp_context_->visit(handle, *this);
   }
 }
 
+void ABY3Lower::collect_fused_products() {
+  size_t size = abp_context_->ops_size();
+  std::vector<size_t> uses(size, 0);
+  for (size_t i = 0; i < size; i++) {
+    for (auto operand : abp_context_->operands(abp::OpHandle(i))) {
+      uses[operand.unwarp()]++;
+    }
+  }
+  for (size_t i = 0; i < size; i++) {
+    abp_context_->visit(abp::OpHandle(i), [&](abp::OpHandle, auto &&op) {
+      using T = std::decay_t<decltype(op)>;
+      if constexpr (std::is_same_v<T, abp::TruncateAOp>) {
+        if (uses[op.operand.unwarp()] != 1) {
+          return;
+        }
+        abp_context_->visit(op.operand, [&](abp::OpHandle product, auto &&op) {
+          using T = std::decay_t<decltype(op)>;
+          if constexpr (std::is_same_v<T, abp::MultiplyAAOp> ||
+                        std::is_same_v<T, abp::DotGeneralAAOp> ||
+                        std::is_same_v<T, abp::DotProductAAOp>) {
+            fused_products_.insert(product);
+          }
+        });
+      }
+    });
+  }
+}
+
+void ABY3Lower::lower_fused(abp::OpHandle handle, abp::OpHandle product,
+                            uint8_t bits) {
+  abp_context_->visit(product, [&](abp::OpHandle, auto &&op) {
+    using T = std::decay_t<decltype(op)>;
+    if constexpr (std::is_same_v<T, abp::MultiplyAAOp> ||
+                  std::is_same_v<T, abp::DotGeneralAAOp> ||
+                  std::is_same_v<T, abp::DotProductAAOp>) {
+      auto left = map_.find(op.left)->second;
+      auto right = map_.find(op.right)->second;
+      auto [left_value, right_value] = unpack_cc(left, right);
+      if constexpr (std::is_same_v<T, abp::MultiplyAAOp>) {
+        push(handle,
+             multiply_truncate_aa(*builder_, left_value, right_value, bits));
+      } else if constexpr (std::is_same_v<T, abp::DotGeneralAAOp>) {
+        push(handle,
+             matmul_truncate_aa(*builder_, left_value, right_value, bits,
+                                op.transpose_left, op.transpose_right));
+      } else {
+        push(handle,
+             dot_product_truncate_aa(*builder_, left_value, right_value, bits));
+      }
+    } else {
+      std::abort();
+    }
+  });
+}
+
 void ABY3Lower::set_value(abp::OpHandle handle, _3pc::PlainValue value) {
   push(handle, cast(value));
 }
@@ -62,6 +120,9 @@ void ABY3Lower::push(abp::OpHandle handle, CipherValue value) {
 }
 
 void ABY3Lower::operator()(abp::OpHandle handle, abp::TruncateAOp op) {
+  if (fused_products_.count(op.operand)) {
+    return lower_fused(handle, op.operand, op.bits);
+  }
   auto operand = get_cipher_value(op.operand);
   auto result = truncate_a(*builder_, cast(operand), op.bits);
   push(handle, result);
@@ -69,7 +130,7 @@ void ABY3Lower::operator()(abp::OpHandle handle, abp::TruncateAOp op) {
 
 void ABY3Lower::operator()(abp::OpHandle handle, abp::A2BOp op) {
   auto operand = get_cipher_value(op.operand);
-  auto result = a2b(*builder_, cast(operand));
+  auto result = a2b(*builder_, cast(operand), op.width);
   push(handle, result);
 }
 
@@ -87,6 +148,9 @@ void ABY3Lower::operator()(abp::OpHandle handle, abp::AddAAOp op) {
 }
 
 void ABY3Lower::operator()(abp::OpHandle handle, abp::MultiplyAAOp op) {
+  if (fused_products_.count(handle)) {
+    return;
+  }
   auto left = map_.find(op.left)->second;
   auto right = map_.find(op.right)->second;
   auto [left_value, right_value] = unpack_cc(left, right);
@@ -108,10 +172,24 @@ void ABY3Lower::operator()(abp::OpHandle handle, abp::AndBBOp op) {
 }
 
 void ABY3Lower::operator()(abp::OpHandle handle, abp::DotGeneralAAOp op) {
+  if (fused_products_.count(handle)) {
+    return;
+  }
+  auto left = map_.find(op.left)->second;
+  auto right = map_.find(op.right)->second;
+  auto [left_value, right_value] = unpack_cc(left, right);
+  push(handle, matmul_aa(*builder_, left_value, right_value, op.transpose_left,
+                         op.transpose_right));
+}
+
+void ABY3Lower::operator()(abp::OpHandle handle, abp::DotProductAAOp op) {
+  if (fused_products_.count(handle)) {
+    return;
+  }
   auto left = map_.find(op.left)->second;
   auto right = map_.find(op.right)->second;
   auto [left_value, right_value] = unpack_cc(left, right);
-  push(handle, matmul_aa(*builder_, left_value, right_value));
+  push(handle, dot_product_aa(*builder_, left_value, right_value));
 }
 
 auto ABY3Lower::unpack_cc(Value x,
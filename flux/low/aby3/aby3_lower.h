@@ -1,6 +1,7 @@
 #pragma once
 
 #include <map>
+#include <set>
 
 #include "fastmpc/abp/dialect/abp_context.h"
 #include "fastmpc/abp/dialect/abp_ops.h"
@@ -24,6 +25,7 @@ public:
   void operator()(abp::OpHandle handle, abp::XorBBOp op);
   void operator()(abp::OpHandle handle, abp::AndBBOp op);
   void operator()(abp::OpHandle handle, abp::DotGeneralAAOp op);
+  void operator()(abp::OpHandle handle, abp::DotProductAAOp op);
 
 private:
   auto get_cipher_value(abp::OpHandle handle) -> _3pc::CipherValue override;
@@ -37,6 +39,12 @@ private:
 
   auto unpack_cc(Value x, Value y) -> std::pair<CipherValue, CipherValue>;
 
+  // Products whose only user is a TruncateAOp; they are lowered together with
+  // that truncation instead of being reshared on their own.
+  void collect_fused_products();
+  void lower_fused(abp::OpHandle handle, abp::OpHandle product, uint8_t bits);
+  std::set<abp::OpHandle> fused_products_;
+
   std::vector<PlainValue> plain_values_;
   std::vector<CipherValue> cipher_values_;
 
@@ -1,4 +1,7 @@
 #include "fastmpc/flux/low/aby3/function/aby3_binary.h"
+#include "fastmpc/flux/low/aby3/function/aby3_unary.h"
+
+#include <utility>
 
 namespace fastmpc::flux::aby3 {
 
@@ -26,9 +29,16 @@ auto xor_bb(FluxBuilder &builder, CipherValue x, CipherValue y) -> CipherValue {
 
 namespace {
 
-template <class Rng, class Add, class Mul, class Sub, class Cast>
-auto mul_impl(Rng &&rng, Add &&add, Mul &&mul, Sub &&sub, Cast &&cast,
-              CipherValue l, CipherValue r) {
+// A 3-out-of-3 sharing of a product: z_i is known to party i only.
+struct CrossTerms {
+  OpHandle z0;
+  OpHandle z1;
+  OpHandle z2;
+};
+
+template <class Rng, class Add, class Mul, class Sub>
+auto cross_terms(Rng &&rng, Add &&add, Mul &&mul, Sub &&sub, CipherValue l,
+                 CipherValue r) -> CrossTerms {
   auto [p2_r0, p0_r0] = rng(2, 0);
   auto [p0_r1, p1_r1] = rng(0, 1);
   auto [p1_r2, p2_r2] = rng(1, 2);
@@ -44,47 +54,177 @@ auto mul_impl(Rng &&rng, Add &&add, Mul &&mul, Sub &&sub, Cast &&cast,
     auto r0_r1 = sub(r0, r1);
     return add(add(x0y0, x0y1), add(x1y0, r0_r1));
   };
-  auto z0 = func(l.p0_x0, r.p0_x0, l.p0_x1, r.p0_x1, p0_r0, p0_r1);
-  auto z1 = func(l.p1_x1, r.p1_x1, l.p1_x2, r.p1_x2, p1_r1, p1_r2);
-  auto z2 = func(l.p2_x2, r.p2_x2, l.p2_x0, r.p2_x0, p2_r2, p2_r0);
-
-  auto result = CipherValue{
-      .p0_x0 = z0,
-      .p0_x1 = cast(z1, 0),
-      .p1_x1 = z1,
-      .p1_x2 = cast(z2, 1),
-      .p2_x2 = z2,
-      .p2_x0 = cast(z0, 2),
+  return CrossTerms{
+      .z0 = func(l.p0_x0, r.p0_x0, l.p0_x1, r.p0_x1, p0_r0, p0_r1),
+      .z1 = func(l.p1_x1, r.p1_x1, l.p1_x2, r.p1_x2, p1_r1, p1_r2),
+      .z2 = func(l.p2_x2, r.p2_x2, l.p2_x0, r.p2_x0, p2_r2, p2_r0),
   };
+}
 
-  return result;
+template <class Cast> auto reshare(Cast &&cast, CrossTerms z) -> CipherValue {
+  return CipherValue{
+      .p0_x0 = z.z0,
+      .p0_x1 = cast(z.z1, 0),
+      .p1_x1 = z.z1,
+      .p1_x2 = cast(z.z2, 1),
+      .p2_x2 = z.z2,
+      .p2_x0 = cast(z.z0, 2),
+  };
 }
-} // namespace
 
-auto multiply_aa(FluxBuilder &builder, CipherValue x,
-                 CipherValue y) -> CipherValue {
-  auto &context = builder.context();
-  auto shape = context.type(x.p0_x0).shape;
+template <class Rng, class Add, class Mul, class Sub, class Cast>
+auto mul_impl(Rng &&rng, Add &&add, Mul &&mul, Sub &&sub, Cast &&cast,
+              CipherValue l, CipherValue r) {
+  return reshare(cast, cross_terms(rng, add, mul, sub, l, r));
+}
+
+// Replaces the resharing of a product with the opening of a truncation.
+// Each z_i is masked by the matching component of a truncation pair and sent
+// to the two holders of x0, so the product is reshared and truncated in the
+// same round.
+auto truncate_terms(FluxBuilder &builder, CrossTerms z, ShapeHandle shape,
+                    uint8_t bits) -> CipherValue {
+  auto [r, shifted] = truncation_pair(builder, shape, bits);
+  auto p0_w0 = builder.subtract(z.z0, r.p0_x0);
+  auto p1_w1 = builder.subtract(z.z1, r.p1_x1);
+  auto p2_w2 = builder.subtract(z.z2, r.p2_x2);
+
+  auto open = [&](OpHandle w0, OpHandle w1, OpHandle w2) {
+    auto c = builder.add(builder.add(w0, w1), w2);
+    return builder.arith_shift_right(c, bits);
+  };
+  auto p0_c = open(p0_w0, builder.cast(p1_w1, 0), builder.cast(p2_w2, 0));
+  auto p2_c = open(builder.cast(p0_w0, 2), builder.cast(p1_w1, 2), p2_w2);
+
+  return CipherValue{
+      .p0_x0 = builder.add(shifted.p0_x0, p0_c),
+      .p0_x1 = shifted.p0_x1,
+      .p1_x1 = shifted.p1_x1,
+      .p1_x2 = shifted.p1_x2,
+      .p2_x2 = shifted.p2_x2,
+      .p2_x0 = builder.add(shifted.p2_x0, p2_c),
+  };
+}
+
+auto multiply_terms(FluxBuilder &builder, CipherValue x, CipherValue y,
+                    ShapeHandle shape) -> CrossTerms {
   auto rng = [&](size_t x, size_t y) { return builder.random(x, y, shape); };
   auto add = [&](OpHandle x, OpHandle y) { return builder.add(x, y); };
   auto mul = [&](OpHandle x, OpHandle y) { return builder.multiply(x, y); };
   auto sub = [&](OpHandle x, OpHandle y) { return builder.subtract(x, y); };
-  auto cast = [&](OpHandle x, size_t y) { return builder.cast(x, y); };
-  return mul_impl(rng, add, mul, sub, cast, x, y);
+  return cross_terms(rng, add, mul, sub, x, y);
 }
 
-auto matmul_aa(FluxBuilder &builder, CipherValue x,
-               CipherValue y) -> CipherValue {
+// Operands of a matmul and whether each one is read transposed.
+struct MatmulOperands {
+  CipherValue x;
+  CipherValue y;
+  bool transpose_x;
+  bool transpose_y;
+};
+
+auto matmul_shape(FluxBuilder &builder, MatmulOperands operands)
+    -> ShapeHandle {
   auto &context = builder.context();
-  size_t row = context.shape(x.p0_x0)[0];
-  size_t column = context.shape(y.p0_x0)[1];
-  auto shape = builder.push(Shape{row, column});
+  auto shape = context.shape(operands.x.p0_x0);
+  auto &y_shape = context.shape(operands.y.p0_x0);
+  size_t rank = shape.size();
+  if (operands.transpose_x) {
+    shape[rank - 2] = shape[rank - 1];
+  }
+  shape[rank - 1] = y_shape[operands.transpose_y ? rank - 2 : rank - 1];
+  return builder.push(std::move(shape));
+}
+
+auto matmul_terms(FluxBuilder &builder, MatmulOperands operands,
+                  ShapeHandle shape) -> CrossTerms {
   auto rng = [&](size_t x, size_t y) { return builder.random(x, y, shape); };
   auto add = [&](OpHandle x, OpHandle y) { return builder.add(x, y); };
-  auto mul = [&](OpHandle x, OpHandle y) { return builder.matmul(x, y); };
+  auto mul = [&](OpHandle x, OpHandle y) {
+    return builder.matmul(x, y, operands.transpose_x, operands.transpose_y);
+  };
   auto sub = [&](OpHandle x, OpHandle y) { return builder.subtract(x, y); };
+  return cross_terms(rng, add, mul, sub, operands.x, operands.y);
+}
+
+struct DotProductShape {
+  DenseSizeTHandle dimensions;
+  ShapeHandle result;
+};
+
+auto dot_product_shape(FluxBuilder &builder, CipherValue x) -> DotProductShape {
+  auto &context = builder.context();
+  auto &shape = context.shape(x.p0_x0);
+  DenseSizeT dimensions(1);
+  dimensions[0] = shape.size() - 1;
+  return DotProductShape{
+      .dimensions = builder.push(std::move(dimensions)),
+      .result = builder.push(Shape(shape.begin(), shape.end() - 1)),
+  };
+}
+
+// Cross terms of an inner product are summed locally before they are
+// reshared, so the whole row costs one element of communication.
+auto dot_product_terms(FluxBuilder &builder, CipherValue x, CipherValue y,
+                       DotProductShape shape) -> CrossTerms {
+  auto rng = [&](size_t x, size_t y) {
+    return builder.random(x, y, shape.result);
+  };
+  auto add = [&](OpHandle x, OpHandle y) { return builder.add(x, y); };
+  auto mul = [&](OpHandle x, OpHandle y) {
+    return builder.reduce_sum(builder.multiply(x, y), shape.dimensions);
+  };
+  auto sub = [&](OpHandle x, OpHandle y) { return builder.subtract(x, y); };
+  return cross_terms(rng, add, mul, sub, x, y);
+}
+
+} // namespace
+
+auto multiply_aa(FluxBuilder &builder, CipherValue x,
+                 CipherValue y) -> CipherValue {
+  auto &context = builder.context();
+  auto shape = context.type(x.p0_x0).shape;
   auto cast = [&](OpHandle x, size_t y) { return builder.cast(x, y); };
-  return mul_impl(rng, add, mul, sub, cast, x, y);
+  return reshare(cast, multiply_terms(builder, x, y, shape));
+}
+
+auto multiply_truncate_aa(FluxBuilder &builder, CipherValue x, CipherValue y,
+                          uint8_t bits) -> CipherValue {
+  auto &context = builder.context();
+  auto shape = context.type(x.p0_x0).shape;
+  auto terms = multiply_terms(builder, x, y, shape);
+  return truncate_terms(builder, terms, shape, bits);
+}
+
+auto matmul_aa(FluxBuilder &builder, CipherValue x, CipherValue y,
+               bool transpose_x, bool transpose_y) -> CipherValue {
+  MatmulOperands operands{x, y, transpose_x, transpose_y};
+  auto shape = matmul_shape(builder, operands);
+  auto cast = [&](OpHandle x, size_t y) { return builder.cast(x, y); };
+  return reshare(cast, matmul_terms(builder, operands, shape));
+}
+
+auto matmul_truncate_aa(FluxBuilder &builder, CipherValue x, CipherValue y,
+                        uint8_t bits, bool transpose_x, bool transpose_y)
+    -> CipherValue {
+  MatmulOperands operands{x, y, transpose_x, transpose_y};
+  auto shape = matmul_shape(builder, operands);
+  auto terms = matmul_terms(builder, operands, shape);
+  return truncate_terms(builder, terms, shape, bits);
+}
+
+auto dot_product_aa(FluxBuilder &builder, CipherValue x,
+                    CipherValue y) -> CipherValue {
+  auto shape = dot_product_shape(builder, x);
+  auto cast = [&](OpHandle x, size_t y) { return builder.cast(x, y); };
+  return reshare(cast, dot_product_terms(builder, x, y, shape));
+}
+
+auto dot_product_truncate_aa(FluxBuilder &builder, CipherValue x,
+                             CipherValue y, uint8_t bits) -> CipherValue {
+  auto shape = dot_product_shape(builder, x);
+  auto terms = dot_product_terms(builder, x, y, shape);
+  return truncate_terms(builder, terms, shape.result, bits);
 }
 
 auto and_bb(FluxBuilder &builder, CipherValue x, CipherValue y) -> CipherValue {
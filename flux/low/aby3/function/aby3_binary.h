@@ -10,7 +10,28 @@ auto add_aa(FluxBuilder &builder, CipherValue x, CipherValue y) -> CipherValue;
 auto multiply_aa(FluxBuilder &builder, CipherValue x, CipherValue y)
     -> CipherValue;
 
-auto matmul_aa(FluxBuilder &builder, CipherValue x, CipherValue y) -> CipherValue;
+// Matrix products of the last two dimensions, the leading batch dimensions are
+// multiplied together and reshared in a single round. A flagged operand is read
+// with its last two dimensions swapped, no share is transposed.
+auto matmul_aa(FluxBuilder &builder, CipherValue x, CipherValue y,
+               bool transpose_x = false, bool transpose_y = false)
+    -> CipherValue;
+
+// Contracts the last dimension of x and y, which must have the same shape.
+auto dot_product_aa(FluxBuilder &builder, CipherValue x, CipherValue y)
+    -> CipherValue;
+
+// Products followed by a truncation of `bits`, resharing and truncating in a
+// single round.
+auto multiply_truncate_aa(FluxBuilder &builder, CipherValue x, CipherValue y,
+                          uint8_t bits) -> CipherValue;
+
+auto matmul_truncate_aa(FluxBuilder &builder, CipherValue x, CipherValue y,
+                        uint8_t bits, bool transpose_x = false,
+                        bool transpose_y = false) -> CipherValue;
+
+auto dot_product_truncate_aa(FluxBuilder &builder, CipherValue x,
+                             CipherValue y, uint8_t bits) -> CipherValue;
 
 auto and_bb(FluxBuilder &builder, CipherValue x, CipherValue y) -> CipherValue;
 
@@ -1,5 +1,8 @@
 #include "fastmpc/flux/low/aby3/function/aby3_casting.h"
 
+#include <bit>
+#include <cassert>
+
 #include "fastmpc/flux/dialect/flux_builder.h"
 #include "fastmpc/flux/low/3pc/function/3pc_unary.h"
 #include "fastmpc/flux/low/aby3/aby3_value.h"
@@ -9,12 +12,12 @@ namespace fastmpc::flux::aby3 {
 
 namespace {
 
-auto kogge_stone(FluxBuilder &builder, CipherValue x,
-                 CipherValue y) -> CipherValue {
+// The carries into the low 2^rounds + 1 bits are exact after `rounds` levels.
+auto kogge_stone(FluxBuilder &builder, CipherValue x, CipherValue y,
+                 size_t rounds) -> CipherValue {
   auto P = xor_bb(builder, x, y);
   auto G = and_bb(builder, x, y);
 
-  constexpr size_t rounds = 63 - __builtin_clzll(64);
   for (size_t idx = 0; idx < rounds; idx++) {
     auto G1 = _3pc::shift_left(builder, cast(G), 1 << idx);
     auto P1 = _3pc::shift_left(builder, cast(P), 1 << idx);
@@ -26,9 +29,27 @@ auto kogge_stone(FluxBuilder &builder, CipherValue x,
   return xor_bb(builder, x, xor_bb(builder, y, cast(C)));
 }
 
+// Copies bit 63 - bits of every share into the bits above it, boolean shares
+// of the sign extension.
+auto sign_extend(FluxBuilder &builder, CipherValue x,
+                 uint8_t bits) -> CipherValue {
+  auto extend = [&](OpHandle share) {
+    return builder.arith_shift_right(builder.shift_left(share, bits), bits);
+  };
+  return CipherValue{
+      .p0_x0 = extend(x.p0_x0),
+      .p0_x1 = extend(x.p0_x1),
+      .p1_x1 = extend(x.p1_x1),
+      .p1_x2 = extend(x.p1_x2),
+      .p2_x2 = extend(x.p2_x2),
+      .p2_x0 = extend(x.p2_x0),
+  };
+}
+
 } // namespace
 
-auto a2b(FluxBuilder &builder, CipherValue in) -> CipherValue {
+auto a2b(FluxBuilder &builder, CipherValue in, uint8_t width) -> CipherValue {
+  assert(width > 0 && width <= 64);
   auto &context = builder.context();
   auto shape = context.type(in.p0_x0).shape;
   auto make_zeros = [&](size_t holder) {
@@ -67,7 +88,12 @@ auto a2b(FluxBuilder &builder, CipherValue in) -> CipherValue {
       .p2_x2 = x0_x2_z2,
       .p2_x0 = builder.cast(z0, 2),
   };
-  return kogge_stone(builder, x, y);
+  size_t rounds = std::bit_width(static_cast<unsigned>(width - 1));
+  auto result = kogge_stone(builder, x, y, rounds);
+  if (width == 64) {
+    return result;
+  }
+  return sign_extend(builder, result, 64 - width);
 }
 
 auto b2a(FluxBuilder &builder, CipherValue in) -> CipherValue {
@@ -93,7 +119,8 @@ auto b2a(FluxBuilder &builder, CipherValue in) -> CipherValue {
       .p2_x0 = builder.cast(z0, 2),
   };
 
-  auto x1 = kogge_stone(builder, in, y);
+  // the full ring, 6 levels
+  auto x1 = kogge_stone(builder, in, y, std::bit_width(63u));
 
   auto p0_x1 = builder._xor(x1.p0_x0, x1.p0_x1);
   p0_x1 = builder._xor(p0_x1, builder.cast(x1.p1_x2, 0));
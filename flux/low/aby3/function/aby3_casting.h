@@ -5,7 +5,11 @@
 
 namespace fastmpc::flux::aby3 {
 
-auto a2b(FluxBuilder &builder, CipherValue x) -> CipherValue;
+// Adds up the low `width` bits of the shares and sign-extends bit width - 1,
+// exact when x fits in `width` bits of two's complement. The adder takes
+// ceil(log2(width)) rounds.
+auto a2b(FluxBuilder &builder, CipherValue x, uint8_t width = 64)
+    -> CipherValue;
 
 auto b2a(FluxBuilder &builder, CipherValue x) -> CipherValue;
 
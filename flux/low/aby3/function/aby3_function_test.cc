@@ -132,6 +132,69 @@ TEST_F(aby3FunctionTest, test_matmul_aa) {
   }
 }
 
+TEST_F(aby3FunctionTest, test_matmul_aa_batched) {
+  // two heads of [1, 2] x [2, 1]
+  const uint64_t x_values[] = {114, 514, 1919, 810};
+  const uint64_t y_values[] = {3, 5, 7, 11};
+  auto x_tensor = eager::Tensor::with_shape({2, 1, 2});
+  auto y_tensor = eager::Tensor::with_shape({2, 2, 1});
+  std::copy(std::begin(x_values), std::end(x_values), x_tensor.data());
+  std::copy(std::begin(y_values), std::end(y_values), y_tensor.data());
+  auto x = input_secret(0, x_tensor);
+  auto y = input_secret(1, y_tensor);
+  auto result = matmul_aa(builder, x, y);
+  output(builder, 0, cast(result));
+  executor.run();
+  {
+    auto result = output_arith(0);
+    EXPECT_EQ(result.at({0, 0, 0}), 114 * 3 + 514 * 5);
+    EXPECT_EQ(result.at({1, 0, 0}), 1919 * 7 + 810 * 11);
+  }
+}
+
+TEST_F(aby3FunctionTest, test_matmul_aa_transposed) {
+  // the operands of test_matmul_aa stored the other way around
+  auto x = input_secret(0, make_tensor<1, 2>({{114, 514}}));
+  auto y = input_secret(1, make_tensor<2, 1>({{1919}, {810}}));
+  auto result = matmul_aa(builder, x, y, true, true);
+  output(builder, 0, cast(result));
+  executor.run();
+  {
+    auto result = output_arith(0);
+    EXPECT_EQ(result.at({0, 0}), 218766);
+    EXPECT_EQ(result.at({0, 1}), 92340);
+    EXPECT_EQ(result.at({1, 0}), 986366);
+    EXPECT_EQ(result.at({1, 1}), 416340);
+  }
+}
+
+TEST_F(aby3FunctionTest, test_truncate_a) {
+  auto x = input_secret(
+      0, make_tensor({114 << 10, static_cast<uint64_t>(-(514 << 10))}));
+  auto result = truncate_a(builder, x, 10);
+  output(builder, 0, cast(result));
+  executor.run();
+  {
+    auto result = output_arith(0);
+    EXPECT_NEAR(static_cast<int64_t>(result.at({0})), 114, 3);
+    EXPECT_NEAR(static_cast<int64_t>(result.at({1})), -514, 3);
+  }
+}
+
+TEST_F(aby3FunctionTest, test_multiply_truncate_aa) {
+  auto x = input_secret(
+      0, make_tensor({114 << 10, static_cast<uint64_t>(-(514 << 10))}));
+  auto y = input_secret(1, make_tensor({1919 << 10, 810 << 10}));
+  auto result = multiply_truncate_aa(builder, x, y, 10);
+  output(builder, 0, cast(result));
+  executor.run();
+  {
+    auto result = output_arith(0);
+    EXPECT_NEAR(static_cast<int64_t>(result.at({0})), (114 * 1919) << 10, 3);
+    EXPECT_NEAR(static_cast<int64_t>(result.at({1})), -(514 * 810) << 10, 3);
+  }
+}
+
 TEST_F(aby3FunctionTest, test_xor_bb) {
   auto x = input_secret(0, make_tensor({114, 514}));
   auto y = input_secret(1, make_tensor({1919, 810}));
@@ -175,6 +238,23 @@ TEST_F(aby3FunctionTest, test_a2b) {
   }
 }
 
+TEST_F(aby3FunctionTest, test_a2b_width) {
+  const int N = 10000;
+  auto input = eager::Tensor::with_shape({N});
+  std::iota(input.data(), input.data() + N, -N / 2);
+
+  auto x = input_secret(0, input);
+  auto result = a2b(builder, x, 16);
+  output(builder, 0, cast(result));
+  executor.run();
+  {
+    auto result = output_boolen(0);
+    for (size_t i = 0; i < N; i++) {
+      EXPECT_EQ(result.at({i}), input.at({i}));
+    }
+  }
+}
+
 TEST_F(aby3FunctionTest, test_b2a) {
   const int N = 10000;
   auto input = eager::Tensor::with_shape({N});
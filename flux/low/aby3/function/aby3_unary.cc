@@ -2,24 +2,76 @@
 
 namespace fastmpc::flux::aby3 {
 
+namespace {
+
+// Every component of r is drawn from [0, 2^61), so r = r0 + r1 + r2 never
+// wraps and r >> bits equals the sum of the shifted components up to the two
+// dropped carries. The opened value x - r stays in range for |x| < 2^61.
+constexpr uint8_t kMaskHeadroom = 3;
+
+} // namespace
+
+auto truncation_pair(FluxBuilder &builder, ShapeHandle shape,
+                     uint8_t bits) -> TruncationPair {
+  auto rng = [&](size_t x, size_t y) {
+    auto [first, second] = builder.random(x, y, shape);
+    return std::make_pair(builder.logic_shift_right(first, kMaskHeadroom),
+                          builder.logic_shift_right(second, kMaskHeadroom));
+  };
+  auto [p2_r0, p0_r0] = rng(2, 0);
+  auto [p0_r1, p1_r1] = rng(0, 1);
+  auto [p1_r2, p2_r2] = rng(1, 2);
+  auto shift = [&](OpHandle r) { return builder.logic_shift_right(r, bits); };
+  return TruncationPair{
+      .r =
+          CipherValue{
+              .p0_x0 = p0_r0,
+              .p0_x1 = p0_r1,
+              .p1_x1 = p1_r1,
+              .p1_x2 = p1_r2,
+              .p2_x2 = p2_r2,
+              .p2_x0 = p2_r0,
+          },
+      .shifted =
+          CipherValue{
+              .p0_x0 = shift(p0_r0),
+              .p0_x1 = shift(p0_r1),
+              .p1_x1 = shift(p1_r1),
+              .p1_x2 = shift(p1_r2),
+              .p2_x2 = shift(p2_r2),
+              .p2_x0 = shift(p2_r0),
+          },
+  };
+}
+
+// Opens c = x - r to the two holders of x0 (one message each), then
+// [x >> bits] = (c >> bits) + [r >> bits] is computed locally.
 auto truncate_a(FluxBuilder &builder, CipherValue x,
                 uint8_t bits) -> CipherValue {
   auto &context = builder.context();
   auto shape = context.type(x.p0_x0).shape;
-  auto [p0_x0, p0_x1, p1_x1, p1_x2, p2_x2, p2_x0] = x;
-  auto [p1_y2, p2_y2] = builder.random(1, 2, shape);
-  auto p0_y0 = builder.arith_shift_right(p0_x0, bits);
-  auto p2_y0 = builder.arith_shift_right(p2_x0, bits);
-  auto p1_y1 = builder.add(p1_x1, p1_x2);
-  p1_y1 = builder.arith_shift_right(p1_y1, bits);
-  auto p0_y1 = builder.cast(p1_y1, 0);
+  auto [r, shifted] = truncation_pair(builder, shape, bits);
+
+  auto p0_c0 = builder.subtract(x.p0_x0, r.p0_x0);
+  auto p0_c1 = builder.subtract(x.p0_x1, r.p0_x1);
+  auto p1_c2 = builder.subtract(x.p1_x2, r.p1_x2);
+  auto p2_c2 = builder.subtract(x.p2_x2, r.p2_x2);
+  auto p2_c0 = builder.subtract(x.p2_x0, r.p2_x0);
+
+  auto open = [&](OpHandle c0, OpHandle c1, OpHandle c2) {
+    auto c = builder.add(builder.add(c0, c1), c2);
+    return builder.arith_shift_right(c, bits);
+  };
+  auto p0_c = open(p0_c0, p0_c1, builder.cast(p1_c2, 0));
+  auto p2_c = open(p2_c0, builder.cast(p0_c1, 2), p2_c2);
+
   return CipherValue{
-      .p0_x0 = p0_y0,
-      .p0_x1 = p0_y1,
-      .p1_x1 = p1_y1,
-      .p1_x2 = p1_y2,
-      .p2_x2 = p2_y2,
-      .p2_x0 = p2_y0,
+      .p0_x0 = builder.add(shifted.p0_x0, p0_c),
+      .p0_x1 = shifted.p0_x1,
+      .p1_x1 = shifted.p1_x1,
+      .p1_x2 = shifted.p1_x2,
+      .p2_x2 = shifted.p2_x2,
+      .p2_x0 = builder.add(shifted.p2_x0, p2_c),
   };
 }
 
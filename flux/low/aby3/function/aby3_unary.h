@@ -5,6 +5,17 @@
 
 namespace fastmpc::flux::aby3 {
 
+// Correlated randomness ([r], [r >> bits]) for one truncation. Both sharings
+// are derived locally from pairwise RandomOps, so no interaction is needed
+// to produce a pair.
+struct TruncationPair {
+  CipherValue r;
+  CipherValue shifted;
+};
+
+auto truncation_pair(FluxBuilder &builder, ShapeHandle shape,
+                     uint8_t bits) -> TruncationPair;
+
 auto truncate_a(FluxBuilder &builder, CipherValue x,
                 uint8_t bits) -> CipherValue;
 